@@ -7,8 +7,217 @@
 #include <algorithm>
 #include <limits> // For std::numeric_limits
 #include <cmath>   // For std::abs
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <iterator>
+#include <string_view>
+#include <iomanip>
+#include <coroutine>
+#include <memory>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+#include <cerrno>
+#include <chrono>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
 using namespace std;
 
+// Phases measured in profiling mode. They nest: dispatchRide and getEta (the pickup ETA shown
+// with a quote) both include findNearestDriver, which includes calculateDistance. recordRide
+// covers the data file writes of a booking.
+enum ProfilePhase
+{
+    PHASE_DISPATCH_RIDE,
+    PHASE_GET_ETA,
+    PHASE_FIND_NEAREST_DRIVER,
+    PHASE_CALCULATE_DISTANCE,
+    PHASE_RECORD_RIDE,
+    PHASE_VIEW_PREVIOUS_RIDES,
+    PHASE_COUNT
+};
+
+const char *PROFILE_PHASE_NAMES[PHASE_COUNT] = {"dispatchRide", "getEta", "findNearestDriver", "calculateDistance", "recordRide", "viewPreviousRides"};
+
+// Hardware events counted for each phase: cycles, instructions, cache misses, branch misses
+const int PROFILE_COUNTER_COUNT = 4;
+
+// Class to collect per-phase hardware counter totals with perf_event_open
+class Profiler
+{
+private:
+    // Structure to represent the running totals of one phase
+    struct PhaseTotals
+    {
+        uint64_t calls;
+        uint64_t counters[PROFILE_COUNTER_COUNT];
+        double wallMs;
+    };
+
+    bool enabled;
+    bool countersAvailable;
+    int groupFd; // Group leader; reading it returns every counter at once
+    PhaseTotals totals[PHASE_COUNT];
+
+public:
+    // Constructor
+    Profiler() : enabled(false), countersAvailable(false), groupFd(-1), totals() {}
+
+    ~Profiler()
+    {
+#ifdef __linux__
+        if (groupFd >= 0)
+        {
+            close(groupFd);
+        }
+#endif
+    }
+
+    bool isEnabled() const { return enabled; }
+
+    // Function to turn profiling on. Without access to hardware counters (no Linux, no PMU,
+    // or perf_event_paranoid too strict) only calls and wall time are reported.
+    void enable()
+    {
+        enabled = true;
+#ifdef __linux__
+        const uint64_t events[PROFILE_COUNTER_COUNT] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i)
+        {
+            perf_event_attr attr = {};
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = events[i];
+            attr.disabled = (i == 0);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            // Count this thread on any CPU
+            int fd = syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+            if (fd < 0)
+            {
+                if (groupFd >= 0)
+                {
+                    close(groupFd); // Closing the leader releases the whole group
+                    groupFd = -1;
+                }
+                return;
+            }
+            if (i == 0)
+            {
+                groupFd = fd;
+            }
+        }
+        ioctl(groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        countersAvailable = true;
+#endif
+    }
+
+    // Function to read the current value of every counter
+    void readCounters(uint64_t values[PROFILE_COUNTER_COUNT]) const
+    {
+        fill(values, values + PROFILE_COUNTER_COUNT, 0);
+#ifdef __linux__
+        if (countersAvailable)
+        {
+            uint64_t group[1 + PROFILE_COUNTER_COUNT]; // Number of counters, then their values
+            if (read(groupFd, group, sizeof(group)) == static_cast<ssize_t>(sizeof(group)))
+            {
+                copy(group + 1, group + 1 + PROFILE_COUNTER_COUNT, values);
+            }
+        }
+#endif
+    }
+
+    // Function to add one measured run of a phase to its totals
+    void add(ProfilePhase phase, const uint64_t start[PROFILE_COUNTER_COUNT], const uint64_t end[PROFILE_COUNTER_COUNT], double wallMs)
+    {
+        totals[phase].calls++;
+        for (int i = 0; i < PROFILE_COUNTER_COUNT; ++i)
+        {
+            totals[phase].counters[i] += end[i] - start[i];
+        }
+        totals[phase].wallMs += wallMs;
+    }
+
+    // Function to print the per-phase totals
+    void report() const
+    {
+        if (!enabled)
+        {
+            return;
+        }
+
+        cout << "Profile (phases nest: dispatchRide and getEta include findNearestDriver, which includes calculateDistance)" << endl;
+        if (!countersAvailable)
+        {
+            cout << "Hardware counters are unavailable; showing calls and wall time only." << endl;
+        }
+        cout << left << setw(20) << "Phase" << right << setw(10) << "Calls" << setw(12) << "Wall ms"
+             << setw(16) << "Cycles" << setw(16) << "Instructions" << setw(8) << "IPC"
+             << setw(14) << "Cache misses" << setw(15) << "Branch misses" << endl;
+        for (int phase = 0; phase < PHASE_COUNT; ++phase)
+        {
+            const PhaseTotals &t = totals[phase];
+            double ipc = t.counters[0] ? static_cast<double>(t.counters[1]) / t.counters[0] : 0;
+            cout << left << setw(20) << PROFILE_PHASE_NAMES[phase] << right << setw(10) << t.calls
+                 << setw(12) << fixed << setprecision(3) << t.wallMs
+                 << setw(16) << t.counters[0] << setw(16) << t.counters[1] << setw(8) << setprecision(2) << ipc
+                 << setw(14) << t.counters[2] << setw(15) << t.counters[3] << endl;
+        }
+        cout.unsetf(ios::floatfield);
+    }
+};
+
+// Profiler shared by every phase; stays disabled unless profiling was requested at startup
+Profiler profiler;
+
+// Class to measure one run of a phase from construction to destruction
+class ProfileScope
+{
+private:
+    ProfilePhase phase;
+    bool active;
+    uint64_t start[PROFILE_COUNTER_COUNT];
+    chrono::steady_clock::time_point startTime;
+
+public:
+    // Constructor
+    explicit ProfileScope(ProfilePhase p) : phase(p), active(profiler.isEnabled())
+    {
+        if (active)
+        {
+            startTime = chrono::steady_clock::now();
+            profiler.readCounters(start);
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (active)
+        {
+            uint64_t end[PROFILE_COUNTER_COUNT];
+            profiler.readCounters(end);
+            double wallMs = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+            profiler.add(phase, start, end, wallMs);
+        }
+    }
+};
+
 // Structure to represent a place
 struct Place
 {
@@ -21,116 +230,1439 @@ struct Place
 };
 
 
-// Function to calculate distance between two geographic coordinates using Haversine formula
-double calculateDistance(double lat1, double lon1, double lat2, double lon2) {
-    const double R = 6371.0; // Radius of the Earth in kilometers
-    double dLat = (lat2 - lat1) * M_PI / 180.0; // Convert degrees to radians
-    double dLon = (lon2 - lon1) * M_PI / 180.0;
+// Function to calculate distance between two geographic coordinates using Haversine formula
+double calculateDistance(double lat1, double lon1, double lat2, double lon2) {
+    const double R = 6371.0; // Radius of the Earth in kilometers
+    double dLat = (lat2 - lat1) * M_PI / 180.0; // Convert degrees to radians
+    double dLon = (lon2 - lon1) * M_PI / 180.0;
+
+    double a = sin(dLat / 2) * sin(dLat / 2) +
+               cos(lat1 * M_PI / 180.0) * cos(lat2 * M_PI / 180.0) *
+               sin(dLon / 2) * sin(dLon / 2);
+    double c = 2 * atan2(sqrt(a), sqrt(1 - a));
+    return R * c; // Distance in kilometers
+}
+
+
+// Structure to represent a ride
+struct Ride
+{
+    string rideID;
+    string userID;
+    string driverID;
+    Place pickupLocation;
+    Place dropoffLocation;
+    double fare;
+    string vehicleType; // Changed to string
+
+    Ride(string id, string user, string driver, Place pickup, Place dropoff, double fareAmount, string vType)
+        : rideID(id), userID(user), driverID(driver), pickupLocation(pickup), dropoffLocation(dropoff), fare(fareAmount), vehicleType(vType) {}
+};
+
+// Vehicle classes the fleet is made of. The class is parsed from text once, when it is typed
+// in or read from a file; everything after that is specialised per class at compile time.
+enum class VehicleClass
+{
+    Car,
+    Auto,
+    Bike,
+    Unknown // Keep last: its value is the number of real classes
+};
+
+// Compile-time traits of each vehicle class
+struct CarTraits
+{
+    static constexpr VehicleClass id = VehicleClass::Car;
+    static constexpr const char *name = "Car";
+    static constexpr int capacity = 4;             // Passenger seats
+    static constexpr double fareRate = 1.0;        // Dollars per km
+    static constexpr double speedKmph = 30.0;      // Average city speed
+    static constexpr double searchRadiusKm = 50.0; // Furthest a driver is sent to a pickup
+};
+
+struct AutoTraits
+{
+    static constexpr VehicleClass id = VehicleClass::Auto;
+    static constexpr const char *name = "Auto";
+    static constexpr int capacity = 3;
+    static constexpr double fareRate = 1.0;
+    static constexpr double speedKmph = 25.0;
+    static constexpr double searchRadiusKm = 30.0;
+};
+
+struct BikeTraits
+{
+    static constexpr VehicleClass id = VehicleClass::Bike;
+    static constexpr const char *name = "Bike";
+    static constexpr int capacity = 1; // Bikes cannot be shared
+    static constexpr double fareRate = 1.0;
+    static constexpr double speedKmph = 35.0;
+    static constexpr double searchRadiusKm = 25.0;
+};
+
+// Function to parse a vehicle type typed by a user or read from a file
+VehicleClass parseVehicleClass(const string &type)
+{
+    if (type == CarTraits::name)
+        return VehicleClass::Car;
+    if (type == AutoTraits::name)
+        return VehicleClass::Auto;
+    if (type == BikeTraits::name)
+        return VehicleClass::Bike;
+    return VehicleClass::Unknown;
+}
+
+// Maximum extra distance (in km) a shared ride may add to the route of an in-progress ride
+const double MAX_POOL_DETOUR_KM = 3.0;
+
+// Structure to represent one stop on the route of a shared ride
+struct PooledStop
+{
+    Place place;
+    bool dropoff; // A passenger leaves here; otherwise one is picked up
+};
+
+// Structure to represent an in-progress shared ride
+struct PooledRide
+{
+    size_t driverIndex; // Position of the driver in its fleet
+    string driverID;
+    string driverName;
+    VehicleClass vehicleClass;
+    double speedKmph;         // Average speed of the vehicle class
+    int seatsTaken;           // Passengers booked who have not been dropped yet
+    Place position;           // Where the vehicle was at lastUpdate
+    time_t lastUpdate;        // Time the route was last advanced
+    vector<PooledStop> stops; // Remaining route stops in visiting order
+
+    PooledRide(size_t index, string driver, string name, VehicleClass vClass, double speed, Place start, Place pickup, Place dropoff)
+        : driverIndex(index), driverID(driver), driverName(name), vehicleClass(vClass), speedKmph(speed), seatsTaken(1),
+          position(start), lastUpdate(time(0)), stops{{pickup, false}, {dropoff, true}} {}
+};
+
+// Function to move a shared ride along its route up to the given time, removing the stops it
+// has reached and freeing a seat at each drop. Returns false once the route is finished.
+bool advancePooledRide(PooledRide &ride, time_t now)
+{
+    double travelKm = (now - ride.lastUpdate) * ride.speedKmph / 3600.0;
+    while (!ride.stops.empty())
+    {
+        const PooledStop &stop = ride.stops.front();
+        double leg = calculateDistance(ride.position.latitude, ride.position.longitude, stop.place.latitude, stop.place.longitude);
+        if (leg > travelKm)
+        {
+            break;
+        }
+        travelKm -= leg;
+        ride.position = stop.place;
+        if (stop.dropoff)
+        {
+            ride.seatsTaken--;
+        }
+        ride.stops.erase(ride.stops.begin());
+    }
+
+    // Travel time not yet used to reach a stop carries over to the next call
+    ride.lastUpdate = now - static_cast<time_t>(travelKm * 3600.0 / ride.speedKmph);
+    return !ride.stops.empty();
+}
+
+// Function to find the in-progress ride that can absorb a new request with the smallest detour.
+// On success the best insertion positions for the pickup and drop are returned through
+// pickupIndex and dropIndex (the new stop is inserted before the stop at that index).
+// The route searched starts at the vehicle's current position, followed by its stops.
+template <typename Traits>
+PooledRide *findPoolingMatch(vector<PooledRide> &activeRides, const Place &pickupPlace, const Place &dropPlace,
+                             size_t &pickupIndex, size_t &dropIndex)
+{
+    PooledRide *bestRide = nullptr;
+    double bestDetour = MAX_POOL_DETOUR_KM;
+
+    // Scratch buffers reused across candidate rides
+    vector<double> legs, toPickup, toDrop;
+
+    for (PooledRide &ride : activeRides)
+    {
+        if (ride.vehicleClass != Traits::id || ride.seatsTaken >= Traits::capacity)
+        {
+            continue;
+        }
+
+        // Compute every distance the insertion search needs in bulk, one pass per array,
+        // so the search below is pure arithmetic over the route arrays. Route point 0 is the
+        // vehicle's position and route point k is stop k-1.
+        size_t n = ride.stops.size() + 1;
+        legs.assign(n, 0.0);
+        toPickup.resize(n);
+        toDrop.resize(n);
+        auto routePoint = [&](size_t k) -> const Place &
+        { return k == 0 ? ride.position : ride.stops[k - 1].place; };
+        for (size_t i = 0; i + 1 < n; ++i)
+        {
+            legs[i] = calculateDistance(routePoint(i).latitude, routePoint(i).longitude,
+                                        routePoint(i + 1).latitude, routePoint(i + 1).longitude);
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            toPickup[i] = calculateDistance(routePoint(i).latitude, routePoint(i).longitude, pickupPlace.latitude, pickupPlace.longitude);
+            toDrop[i] = calculateDistance(routePoint(i).latitude, routePoint(i).longitude, dropPlace.latitude, dropPlace.longitude);
+        }
+        double pickupToDrop = calculateDistance(pickupPlace.latitude, pickupPlace.longitude, dropPlace.latitude, dropPlace.longitude);
+
+        // The pickup goes after route point i-1 and the drop after route point j-1 (j >= i);
+        // nothing can be inserted before the vehicle's own position
+        for (size_t i = 1; i <= n; ++i)
+        {
+            bool pickupAtEnd = (i == n);
+            double pickupDetour = pickupAtEnd ? toPickup[i - 1]
+                                              : toPickup[i - 1] + toPickup[i] - legs[i - 1];
+
+            // Drop immediately after the pickup
+            double sameGap = pickupAtEnd ? toPickup[i - 1] + pickupToDrop
+                                         : toPickup[i - 1] + pickupToDrop + toDrop[i] - legs[i - 1];
+            if (sameGap < bestDetour)
+            {
+                bestDetour = sameGap;
+                bestRide = &ride;
+                pickupIndex = i - 1;
+                dropIndex = i - 1;
+            }
+
+            // Drop further along the route
+            for (size_t j = i + 1; j <= n; ++j)
+            {
+                double dropDetour = (j == n) ? toDrop[j - 1]
+                                             : toDrop[j - 1] + toDrop[j] - legs[j - 1];
+                double detour = pickupDetour + dropDetour;
+                if (detour < bestDetour)
+                {
+                    bestDetour = detour;
+                    bestRide = &ride;
+                    pickupIndex = i - 1;
+                    dropIndex = j - 1;
+                }
+            }
+        }
+    }
+
+    return bestRide;
+}
+
+// Function to add a passenger's stops to a shared ride at the positions chosen by findPoolingMatch
+void joinPooledRide(PooledRide &ride, const Place &pickupPlace, const Place &dropPlace, size_t pickupIndex, size_t dropIndex)
+{
+    ride.stops.insert(ride.stops.begin() + dropIndex, PooledStop{dropPlace, true});
+    ride.stops.insert(ride.stops.begin() + pickupIndex, PooledStop{pickupPlace, false});
+    ride.seatsTaken++;
+}
+
+// Parent class for Human
+class Human
+{
+protected:
+    string name;
+    int age;
+    string phoneNumber;
+
+public:
+    // Constructor
+    Human(string n, int a, string phone) : name(n), age(a), phoneNumber(phone) {}
+
+    // Getters
+    string getName() const { return name; }
+    int getAge() const { return age; }
+    string getPhoneNumber() const { return phoneNumber; }
+};
+
+// Parent class for Vehicle
+class Vehicle
+{
+protected:
+    string vehicleNumber;
+    string type; // Changed to string
+
+public:
+    // Constructor
+    Vehicle(string vNum, string t) : vehicleNumber(vNum), type(t) {}
+
+    // Getters
+    string getVehicleNumber() const { return vehicleNumber; }
+    string getType() const { return type; }
+};
+
+// Coroutine type for session logic. A Task starts suspended and runs when it is co_awaited;
+// when it finishes, control transfers straight back to the coroutine that awaited it.
+template <typename T = void>
+class Task;
+
+// Promise state shared by every Task
+struct TaskPromiseBase
+{
+    coroutine_handle<> continuation; // Coroutine waiting for this task to finish
+    exception_ptr error;
+
+    // Awaiter that resumes the waiting coroutine once the task has finished
+    struct FinalAwaiter
+    {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        coroutine_handle<> await_suspend(coroutine_handle<Promise> finished) noexcept
+        {
+            coroutine_handle<> continuation = finished.promise().continuation;
+            return continuation ? continuation : noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase
+{
+    T value;
+
+    Task<T> get_return_object();
+    void return_value(T v) { value = v; }
+    T result()
+    {
+        if (error)
+        {
+            rethrow_exception(error);
+        }
+        return value;
+    }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase
+{
+    Task<void> get_return_object();
+    void return_void() {}
+    void result()
+    {
+        if (error)
+        {
+            rethrow_exception(error);
+        }
+    }
+};
+
+template <typename T>
+class Task
+{
+public:
+    using promise_type = TaskPromise<T>;
+
+    // Constructors; a Task owns its coroutine frame and can only be moved
+    explicit Task(coroutine_handle<promise_type> h) : handle(h) {}
+    Task(Task &&other) noexcept : handle(exchange(other.handle, nullptr)) {}
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+            {
+                handle.destroy();
+            }
+            handle = exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~Task()
+    {
+        if (handle)
+        {
+            handle.destroy();
+        }
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    coroutine_handle<> await_suspend(coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() { return handle.promise().result(); }
+
+    // Function to start a top-level task that nothing awaits
+    void start() { handle.resume(); }
+
+    bool done() const { return !handle || handle.done(); }
+
+private:
+    coroutine_handle<promise_type> handle;
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object() { return Task<T>(coroutine_handle<TaskPromise<T>>::from_promise(*this)); }
+
+inline Task<void> TaskPromise<void>::get_return_object() { return Task<void>(coroutine_handle<TaskPromise<void>>::from_promise(*this)); }
+
+// Class to represent one interactive session: its input stream and the coroutine running its menus
+class Session
+{
+private:
+    int inputFd;
+    string pending;              // Input received but not consumed yet
+    coroutine_handle<> waiting;  // Coroutine suspended until a full line arrives
+    bool closed;                 // The input reached end of file
+    Task<> root;                 // Top-level menu of the session
+
+    bool hasLine() const { return pending.find('\n') != string::npos || (closed && !pending.empty()); }
+
+public:
+    // Constructor
+    explicit Session(int fd) : inputFd(fd), waiting(nullptr), closed(false), root(nullptr) {}
+
+    int getInputFd() const { return inputFd; }
+
+    // Awaiter returned by readLine()
+    struct LineAwaiter
+    {
+        Session &session;
+
+        bool await_ready() const { return session.hasLine(); }
+        void await_suspend(coroutine_handle<> h) { session.waiting = h; }
+        string await_resume()
+        {
+            size_t end = session.pending.find('\n');
+            string line = session.pending.substr(0, end);
+            session.pending.erase(0, end == string::npos ? string::npos : end + 1);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            return line;
+        }
+    };
+
+    // Function to wait for the next line of input, without the newline
+    LineAwaiter readLine() { return LineAwaiter{*this}; }
+
+    // Function to run the session's top-level menu until it first waits for input
+    void start(Task<> menu)
+    {
+        root = move(menu);
+        root.start();
+    }
+
+    // Function to hand newly read input to the session, resuming it if it was waiting for a line
+    void receive(const char *data, size_t size)
+    {
+        if (size == 0)
+        {
+            closed = true;
+        }
+        pending.append(data, size);
+
+        if (waiting && hasLine())
+        {
+            exchange(waiting, nullptr).resume();
+        }
+    }
+
+    // A session ends when its menu returns, or when it waits for input that will never come
+    bool finished() const { return root.done() || (closed && !hasLine()); }
+
+    // Function to pass on an exception that escaped the session's menu
+    void rethrowError()
+    {
+        if (root.done())
+        {
+            root.await_resume();
+        }
+    }
+};
+
+// Class to drive many sessions on one thread, resuming each one as its input arrives
+class EventLoop
+{
+private:
+    unordered_map<Session *, unique_ptr<Session>> sessions;
+#ifdef __linux__
+    int epollFd;
+    vector<Session *> alwaysReady; // Regular files cannot be watched by epoll but never block
+#endif
+
+    // Function to drop a finished session, passing on any error from its menu
+    void removeSession(Session *session)
+    {
+        session->rethrowError();
+#ifdef __linux__
+        if (epoll_ctl(epollFd, EPOLL_CTL_DEL, session->getInputFd(), nullptr) != 0)
+        {
+            // Not watched by epoll, so it is one of the few always-ready sessions
+            auto it = find(alwaysReady.begin(), alwaysReady.end(), session);
+            *it = alwaysReady.back();
+            alwaysReady.pop_back();
+        }
+#endif
+        sessions.erase(session);
+    }
+
+#ifdef __linux__
+    // Function to pass a session the input waiting on its file descriptor, removing the
+    // session if that finishes it. Returns false if the session was removed.
+    bool serve(Session *session, char *buffer, size_t size)
+    {
+        ssize_t bytes = read(session->getInputFd(), buffer, size);
+        if (bytes < 0 && errno == EINTR)
+        {
+            return true;
+        }
+        session->receive(buffer, bytes > 0 ? bytes : 0);
+        if (!session->finished())
+        {
+            return true;
+        }
+        removeSession(session);
+        return false;
+    }
+#endif
+
+public:
+    // Constructor
+    EventLoop()
+    {
+#ifdef __linux__
+        epollFd = epoll_create1(0);
+#endif
+    }
+
+    ~EventLoop()
+    {
+#ifdef __linux__
+        close(epollFd);
+#endif
+    }
+
+    // Function to register a session reading from the given file descriptor
+    Session &addSession(int fd)
+    {
+        unique_ptr<Session> owned = make_unique<Session>(fd);
+        Session *session = owned.get();
+        sessions.emplace(session, move(owned));
+#ifdef __linux__
+        epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.ptr = session; // Events lead straight to their session
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            alwaysReady.push_back(session);
+        }
+#endif
+        return *session;
+    }
+
+    // Function to run until every session has finished
+    void run()
+    {
+        char buffer[4096];
+        vector<Session *> finishedEarly;
+        for (auto &entry : sessions)
+        {
+            if (entry.second->finished())
+            {
+                finishedEarly.push_back(entry.first);
+            }
+        }
+        for (Session *session : finishedEarly)
+        {
+            removeSession(session);
+        }
+
+        while (!sessions.empty())
+        {
+            cout.flush(); // Prompts are written without endl; show them before waiting
+
+#ifdef __linux__
+            epoll_event events[64];
+            int count = epoll_wait(epollFd, events, 64, alwaysReady.empty() ? -1 : 0);
+            for (int i = 0; i < count; ++i)
+            {
+                serve(static_cast<Session *>(events[i].data.ptr), buffer, sizeof(buffer));
+            }
+
+            // A removed session is replaced by the last one, so only advance past kept ones
+            for (size_t i = 0; i < alwaysReady.size();)
+            {
+                if (serve(alwaysReady[i], buffer, sizeof(buffer)))
+                {
+                    ++i;
+                }
+            }
+#else
+            // Without epoll only the console session can be served
+            Session *console = sessions.begin()->second.get();
+            string line;
+            if (getline(cin, line))
+            {
+                line += '\n';
+                console->receive(line.data(), line.size());
+            }
+            else
+            {
+                console->receive(buffer, 0);
+            }
+            if (console->finished())
+            {
+                removeSession(console);
+            }
+#endif
+        }
+        cout.flush();
+    }
+};
+
+// Function to read a number typed on its own line; anything that is not a number reads as -1
+Task<int> readNumber(Session &session)
+{
+    string line = co_await session.readLine();
+    try
+    {
+        co_return stoi(line);
+    }
+    catch (const exception &)
+    {
+        co_return -1;
+    }
+}
+
+// Number of days a ride log segment stays as plain text before it is compacted
+const int RIDE_COMPACT_AFTER_DAYS = 7;
+
+// Seconds between background compaction passes
+const int RIDE_COMPACT_INTERVAL_SECONDS = 60 * 60;
+
+// Number of days of ride history to keep (0 keeps it forever)
+const int RIDE_RETENTION_DAYS = 0;
+
+// Size of the bloom filter of user and driver IDs of a new live segment (about 2600 IDs)
+const size_t RIDE_BLOOM_BITS = 32768;
+
+// Number of hash probes per ID in a segment's bloom filter
+const int RIDE_BLOOM_HASHES = 3;
+
+// Target false positive rate of a segment's bloom filter. Once a live segment's filter is too
+// full to meet it, the day's rides continue in a new segment.
+const double RIDE_BLOOM_FALSE_POSITIVE_RATE = 0.01;
+
+// File listing the ride log segments and their summaries
+const string RIDE_SEGMENT_INDEX = "ride_segments.txt";
+
+// Guards the ride log against the background compaction thread
+mutex rideLogMutex;
+
+// Function to hash a string (FNV-1a); unlike std::hash it is stable, so it can be persisted
+uint64_t stableHash(const string &text, uint64_t seed)
+{
+    uint64_t hash = 14695981039346656037ULL ^ seed;
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Function to get the bloom filter size (a multiple of 64 bits) that holds the given number of
+// IDs at the target false positive rate
+size_t bloomBitsFor(size_t ids)
+{
+    double bitsPerID = -RIDE_BLOOM_HASHES / log(1.0 - pow(RIDE_BLOOM_FALSE_POSITIVE_RATE, 1.0 / RIDE_BLOOM_HASHES));
+    size_t bits = static_cast<size_t>(ceil(max<size_t>(ids, 1) * bitsPerID));
+    return (bits + 63) / 64 * 64;
+}
+
+// Structure to represent one segment of the ride log and its summary
+struct RideSegment
+{
+    string name;    // File name without extension, e.g. rides-20241119 or rides-20241119-2
+    time_t minTime; // Time of the first ride in the segment
+    time_t maxTime; // Time of the last ride in the segment
+    bool compacted; // Stored as a compressed columnar .col file instead of a .txt file
+    size_t bloomBits;      // Size of the bloom filter; 0 means the segment has no summary
+    size_t bloomSetBits;   // Number of bits set, to tell when the filter is full
+    vector<uint64_t> bloom; // User and driver IDs that appear in the segment
+
+    RideSegment(string n, time_t created, size_t bits)
+        : name(n), minTime(created), maxTime(created), compacted(false), bloomBits(bits), bloomSetBits(0), bloom(bits / 64, 0) {}
+
+    string fileName() const { return name + (compacted ? ".col" : ".txt"); }
+
+    bool testBit(size_t bit) const { return (bloom[bit / 64] >> (bit % 64)) & 1; }
+
+    void setBit(size_t bit)
+    {
+        if (!testBit(bit))
+        {
+            bloom[bit / 64] |= 1ULL << (bit % 64);
+            bloomSetBits++;
+        }
+    }
+
+    // Function to add a user or driver ID to the bloom filter
+    void addID(const string &id)
+    {
+        if (bloomBits == 0)
+        {
+            return;
+        }
+        uint64_t h1 = stableHash(id, 0);
+        uint64_t h2 = stableHash(id, 1) | 1;
+        for (uint64_t i = 0; i < RIDE_BLOOM_HASHES; ++i)
+        {
+            setBit((h1 + i * h2) % bloomBits);
+        }
+    }
+
+    // Function to check whether the segment may contain rides of a user or driver
+    bool mayContain(const string &id) const
+    {
+        if (bloomBits == 0)
+        {
+            return true;
+        }
+        uint64_t h1 = stableHash(id, 0);
+        uint64_t h2 = stableHash(id, 1) | 1;
+        for (uint64_t i = 0; i < RIDE_BLOOM_HASHES; ++i)
+        {
+            if (!testBit((h1 + i * h2) % bloomBits))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Function to check whether the filter is too full to meet the target false positive rate
+    bool bloomFull() const
+    {
+        return bloomBits > 0 && pow(static_cast<double>(bloomSetBits) / bloomBits, RIDE_BLOOM_HASHES) > RIDE_BLOOM_FALSE_POSITIVE_RATE;
+    }
+};
+
+// Function to get the name of the daily segment a ride recorded at the given time belongs to
+string segmentNameForTime(time_t when)
+{
+    char name[32];
+    strftime(name, sizeof(name), "rides-%Y%m%d", localtime(&when));
+    return name;
+}
+
+// In-memory copy of the segment index, loaded on first use (guarded by rideLogMutex)
+vector<RideSegment> rideSegmentIndex;
+bool rideSegmentIndexLoaded = false;
+bool rideSegmentIndexDirty = false; // Holds changes not yet written to the index file
+
+// Function to load the segment index file (caller holds rideLogMutex)
+vector<RideSegment> loadRideSegmentIndex()
+{
+    ifstream indexFile(RIDE_SEGMENT_INDEX);
+    vector<RideSegment> segments;
+    string line;
+
+    while (getline(indexFile, line))
+    {
+        // Each line is: name,minTime,maxTime,compacted,bloom filter bits,bloom filter in hex.
+        // Older indexes have no bit count and a fixed 512-bit filter.
+        stringstream ss(line);
+        string name, minTime, maxTime, compacted, bloomHex;
+        getline(ss, name, ',');
+        getline(ss, minTime, ',');
+        getline(ss, maxTime, ',');
+        getline(ss, compacted, ',');
+        getline(ss, bloomHex);
+        size_t comma = bloomHex.find(',');
+        size_t bits = bloomHex.size() * 4;
+        if (comma != string::npos)
+        {
+            bits = strtoul(bloomHex.substr(0, comma).c_str(), nullptr, 10);
+            bloomHex.erase(0, comma + 1);
+        }
+        if (bits == 0 || bits % 64 != 0 || bloomHex.size() != bits / 4)
+        {
+            continue;
+        }
+
+        RideSegment segment(name, stoll(minTime), bits);
+        segment.maxTime = stoll(maxTime);
+        segment.compacted = (compacted == "1");
+        for (size_t i = 0; i < bloomHex.size(); ++i)
+        {
+            int nibble = stoi(bloomHex.substr(i, 1), nullptr, 16);
+            for (int bit = 0; bit < 4; ++bit)
+            {
+                if ((nibble >> bit) & 1)
+                {
+                    segment.setBit(i * 4 + bit);
+                }
+            }
+        }
+        segments.push_back(segment);
+    }
+    indexFile.close();
+    return segments;
+}
+
+// Function to get the segment index, loading it on first use (caller holds rideLogMutex)
+vector<RideSegment> &rideSegments()
+{
+    if (!rideSegmentIndexLoaded)
+    {
+        rideSegmentIndex = loadRideSegmentIndex();
+        rideSegmentIndexLoaded = true;
+    }
+    return rideSegmentIndex;
+}
+
+// Function to save the segment index (caller holds rideLogMutex).
+// The index is written to a temporary file and renamed into place, so a crash part way
+// through leaves the previous index intact instead of an empty one.
+void saveRideSegmentIndex()
+{
+    const char *hexDigits = "0123456789abcdef";
+    string tempName = RIDE_SEGMENT_INDEX + ".tmp";
+    ofstream indexFile(tempName);
+    for (const RideSegment &segment : rideSegments())
+    {
+        string bloomHex;
+        for (size_t i = 0; i < segment.bloomBits; i += 4)
+        {
+            int nibble = (segment.bloom[i / 64] >> (i % 64)) & 0xf;
+            bloomHex += hexDigits[nibble];
+        }
+        indexFile << segment.name << "," << segment.minTime << "," << segment.maxTime << ","
+                  << (segment.compacted ? 1 : 0) << "," << segment.bloomBits << "," << bloomHex << "\n";
+    }
+    indexFile.close();
+
+    if (indexFile)
+    {
+        rename(tempName.c_str(), RIDE_SEGMENT_INDEX.c_str());
+        rideSegmentIndexDirty = false;
+    }
+}
+
+// Function to find the latest segment of a day, if any, and its part number (caller holds
+// rideLogMutex). A day's segments are named rides-YYYYMMDD, rides-YYYYMMDD-2 and so on.
+RideSegment *latestRideSegment(time_t when, int &latestPart)
+{
+    string base = segmentNameForTime(when);
+    RideSegment *latest = nullptr;
+    latestPart = 0;
+    for (RideSegment &segment : rideSegments())
+    {
+        int part = 0;
+        if (segment.name == base)
+        {
+            part = 1;
+        }
+        else if (segment.name.compare(0, base.size() + 1, base + "-") == 0)
+        {
+            part = atoi(segment.name.c_str() + base.size() + 1);
+        }
+        if (part > latestPart)
+        {
+            latestPart = part;
+            latest = &segment;
+        }
+    }
+    return latest;
+}
+
+// Function to add a new segment for the day to the index (caller holds rideLogMutex)
+RideSegment &addRideSegment(time_t when, size_t bloomBits)
+{
+    int latestPart;
+    latestRideSegment(when, latestPart);
+    string name = segmentNameForTime(when);
+    if (latestPart > 0)
+    {
+        name += "-" + to_string(latestPart + 1);
+    }
+    rideSegments().emplace_back(name, when, bloomBits);
+    return rideSegments().back();
+}
+
+// Function to get the segment new rides go to: the day's latest segment, or a new one if the
+// day has none yet or the latest one's bloom filter is full (caller holds rideLogMutex)
+RideSegment &currentRideSegment(time_t now, bool &added)
+{
+    int latestPart;
+    RideSegment *latest = latestRideSegment(now, latestPart);
+    added = (latest == nullptr || latest->bloomFull());
+    return added ? addRideSegment(now, RIDE_BLOOM_BITS) : *latest;
+}
+
+// Function to list every segment of the ride log, oldest first (caller holds rideLogMutex).
+// The original rides.txt predates segments, has no summary and is always scanned.
+vector<RideSegment> listRideSegments()
+{
+    vector<RideSegment> segments;
+    if (ifstream("rides.txt").is_open())
+    {
+        segments.emplace_back("rides", 0, 0); // No bloom filter, so it may contain anyone
+
+    }
+
+    vector<RideSegment> indexed = rideSegments();
+    sort(indexed.begin(), indexed.end(), [](const RideSegment &a, const RideSegment &b)
+         { return a.minTime < b.minTime; });
+    segments.insert(segments.end(), indexed.begin(), indexed.end());
+    return segments;
+}
+
+// Function to read a compacted segment back into ride log lines.
+// A .col file holds the row count followed by one dictionary line and one run-length
+// encoded line of dictionary indexes (index*count,...) for each of the seven ride fields.
+vector<string> loadCompactedSegment(const string &fileName)
+{
+    ifstream colFile(fileName);
+    string line;
+    vector<string> rows;
+
+    if (!getline(colFile, line))
+    {
+        return rows;
+    }
+    rows.assign(stoul(line), "");
+
+    for (int column = 0; column < 7; ++column)
+    {
+        string dictionaryLine, runsLine, entry;
+        getline(colFile, dictionaryLine);
+        getline(colFile, runsLine);
+
+        vector<string> dictionary;
+        stringstream dictionaryStream(dictionaryLine);
+        while (getline(dictionaryStream, entry, ','))
+        {
+            dictionary.push_back(entry);
+        }
+
+        size_t row = 0;
+        stringstream runsStream(runsLine);
+        while (getline(runsStream, entry, ',') && row < rows.size())
+        {
+            size_t star = entry.find('*');
+            size_t index = stoul(entry.substr(0, star));
+            size_t count = stoul(entry.substr(star + 1));
+            for (size_t i = 0; i < count && row < rows.size(); ++i, ++row)
+            {
+                if (column > 0)
+                {
+                    rows[row] += ",";
+                }
+                rows[row] += (index < dictionary.size() ? dictionary[index] : "");
+            }
+        }
+    }
+    colFile.close();
+    return rows;
+}
+
+// Function to rewrite a text segment as a compressed columnar file
+bool writeCompactedSegment(const string &textFileName, const string &colFileName)
+{
+    ifstream textFile(textFileName);
+    if (!textFile.is_open())
+    {
+        return false;
+    }
+    string line;
+    vector<vector<string>> columns(7);
+    size_t rowCount = 0;
+
+    while (getline(textFile, line))
+    {
+        vector<string> rideDetails;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, ','))
+        {
+            rideDetails.push_back(field);
+        }
+        if (rideDetails.size() != 7)
+        {
+            continue;
+        }
+        for (int column = 0; column < 7; ++column)
+        {
+            columns[column].push_back(rideDetails[column]);
+        }
+        rowCount++;
+    }
+    textFile.close();
+
+    ofstream colFile(colFileName);
+    colFile << rowCount << "\n";
+    for (const vector<string> &values : columns)
+    {
+        // Dictionary encode the column, then run-length encode the dictionary indexes
+        vector<string> dictionary;
+        unordered_map<string, size_t> dictionaryIndex;
+        vector<size_t> indexes;
+        for (const string &value : values)
+        {
+            auto entry = dictionaryIndex.emplace(value, dictionary.size());
+            if (entry.second)
+            {
+                dictionary.push_back(value);
+            }
+            indexes.push_back(entry.first->second);
+        }
+
+        for (size_t i = 0; i < dictionary.size(); ++i)
+        {
+            colFile << (i > 0 ? "," : "") << dictionary[i];
+        }
+        colFile << "\n";
+
+        for (size_t i = 0; i < indexes.size();)
+        {
+            size_t run = 1;
+            while (i + run < indexes.size() && indexes[i + run] == indexes[i])
+            {
+                run++;
+            }
+            colFile << (i > 0 ? "," : "") << indexes[i] << "*" << run;
+            i += run;
+        }
+        colFile << "\n";
+    }
+    colFile.close();
+    return static_cast<bool>(colFile);
+}
+
+// Function to compact old segments and drop segments past the retention period.
+// rideLogMutex is only held to pick the segments and to switch each one over to its new
+// file; the .col file is written to a temporary name without the lock, which is safe as
+// rides are only ever appended to today's segment. The text file of a compacted segment is
+// removed on the following pass, so a history screen that is already open can keep reading it.
+void compactRideLog(const atomic<bool> &stopRequested)
+{
+    vector<string> toCompact;
+    {
+        lock_guard<mutex> lock(rideLogMutex);
+        vector<RideSegment> &segments = rideSegments();
+        vector<RideSegment> kept;
+        time_t now = time(0);
+        bool changed = false;
+
+        for (const RideSegment &segment : segments)
+        {
+            if (RIDE_RETENTION_DAYS > 0 && segment.maxTime < now - RIDE_RETENTION_DAYS * 24 * 60 * 60)
+            {
+                remove((segment.name + ".txt").c_str());
+                remove((segment.name + ".col").c_str());
+                changed = true;
+                continue;
+            }
+
+            if (segment.compacted)
+            {
+                remove((segment.name + ".txt").c_str()); // Left over from the previous pass
+            }
+            else if (segment.maxTime < now - RIDE_COMPACT_AFTER_DAYS * 24 * 60 * 60)
+            {
+                toCompact.push_back(segment.name);
+            }
+            kept.push_back(segment);
+        }
+
+        if (changed)
+        {
+            segments = kept;
+            saveRideSegmentIndex();
+        }
+    }
+
+    for (const string &name : toCompact)
+    {
+        if (stopRequested)
+        {
+            return;
+        }
+
+        string tempName = name + ".col.tmp";
+        bool written = writeCompactedSegment(name + ".txt", tempName);
+
+        lock_guard<mutex> lock(rideLogMutex);
+        vector<RideSegment> &segments = rideSegments();
+        auto segment = find_if(segments.begin(), segments.end(), [&](const RideSegment &s)
+                               { return s.name == name; });
+        if (!written || segment == segments.end() || segment->compacted ||
+            rename(tempName.c_str(), (name + ".col").c_str()) != 0)
+        {
+            remove(tempName.c_str());
+            continue;
+        }
+        segment->compacted = true;
+        saveRideSegmentIndex();
+    }
+}
+
+// Class to run compaction passes on a background thread until it is stopped
+class RideLogCompactor
+{
+private:
+    thread worker;
+    mutex stopMutex;
+    condition_variable stopSignal;
+    atomic<bool> stopping{false};
+
+    void run()
+    {
+        unique_lock<mutex> lock(stopMutex);
+        while (!stopping)
+        {
+            lock.unlock();
+            compactRideLog(stopping);
+            lock.lock();
+            stopSignal.wait_for(lock, chrono::seconds(RIDE_COMPACT_INTERVAL_SECONDS), [this]
+                                { return stopping.load(); });
+        }
+    }
+
+public:
+    void start() { worker = thread(&RideLogCompactor::run, this); }
+
+    // Function to stop the thread; a pass in progress finishes its current segment first
+    void stop()
+    {
+        {
+            lock_guard<mutex> lock(stopMutex);
+            stopping = true;
+        }
+        stopSignal.notify_all();
+        if (worker.joinable())
+        {
+            worker.join();
+        }
+    }
+};
+
+// Class to read the lines of one ride log segment, from either its text or its columnar form
+class RideSegmentReader
+{
+private:
+    bool compacted;
+    ifstream textFile;
+    vector<string> rows; // Rows of a compacted segment
+    size_t row;
+
+public:
+    // Constructor; a compacted segment is decoded once, up front
+    RideSegmentReader(const RideSegment &segment) : compacted(segment.compacted), row(0)
+    {
+        if (compacted)
+        {
+            rows = loadCompactedSegment(segment.fileName());
+        }
+        else
+        {
+            textFile.open(segment.fileName());
+        }
+    }
+
+    bool next(string &line)
+    {
+        if (compacted)
+        {
+            if (row >= rows.size())
+            {
+                return false;
+            }
+            line = rows[row++];
+            return true;
+        }
+        return static_cast<bool>(getline(textFile, line));
+    }
+};
+
+// Structure to represent a position in the ride log
+struct RideCursor
+{
+    size_t segment = 0;                   // Index into the segment list
+    unique_ptr<RideSegmentReader> reader; // Reader for that segment, kept open between pages
+    vector<string> nextRide;              // Matching ride already read ahead for the next page
+};
+
+// File holding the running ride statistics of every user and driver
+const string RIDE_STATS_FILE = "ride_stats.txt";
+
+// Structure to represent the running ride statistics of a user or a driver
+struct RideStats
+{
+    int trips;
+    double totalFare;
+    map<string, int> tripsByVehicleType;
+    string lastRideID;
+
+    RideStats() : trips(0), totalFare(0) {}
+
+    void addRide(const string &rideID, double fare, const string &vehicleType)
+    {
+        trips++;
+        totalFare += fare;
+        tripsByVehicleType[vehicleType]++;
+        lastRideID = rideID;
+    }
+};
+
+// Class to keep per-user and per-driver ride statistics up to date as rides are recorded.
+// The stats file is append-only: every ride appends the new totals of its user and driver,
+// and the latest line for a username wins when the file is loaded.
+class RideStatsStore
+{
+private:
+    unordered_map<string, RideStats> userStats;
+    unordered_map<string, RideStats> driverStats;
+
+    // Function to append one stats entry to the stats file
+    static void writeEntry(ostream &out, const string &role, const string &username, const RideStats &stats)
+    {
+        out << role << "," << username << "," << stats.trips << "," << fixed << setprecision(2) << stats.totalFare << "," << stats.lastRideID << ",";
+        bool first = true;
+        for (const auto &entry : stats.tripsByVehicleType)
+        {
+            out << (first ? "" : ";") << entry.first << ":" << entry.second;
+            first = false;
+        }
+        out << "\n";
+    }
+
+    // Function to rebuild every statistic from the ride log, for data recorded before the stats file existed
+    void rebuildFromRideLog()
+    {
+        lock_guard<mutex> lock(rideLogMutex);
+        for (const RideSegment &segment : listRideSegments())
+        {
+            RideSegmentReader reader(segment);
+            string line;
+            while (reader.next(line))
+            {
+                vector<string> rideDetails;
+                stringstream ss(line);
+                string field;
+                while (getline(ss, field, ','))
+                {
+                    rideDetails.push_back(field);
+                }
+                if (rideDetails.size() != 7)
+                {
+                    continue;
+                }
+                double fare = stod(rideDetails[5]);
+                userStats[rideDetails[1]].addRide(rideDetails[0], fare, rideDetails[6]);
+                driverStats[rideDetails[2]].addRide(rideDetails[0], fare, rideDetails[6]);
+            }
+        }
+    }
+
+public:
+    // Function to load the statistics, rebuilding them from the ride log if there is no stats file yet
+    void load()
+    {
+        ifstream statsFile(RIDE_STATS_FILE);
+        if (!statsFile.is_open())
+        {
+            rebuildFromRideLog();
+            save();
+            return;
+        }
+
+        string line;
+        size_t entries = 0;
+        while (getline(statsFile, line))
+        {
+            // Each line is: role,username,trips,totalFare,lastRideID,type:count;type:count
+            stringstream ss(line);
+            string role, username, trips, totalFare, lastRideID, byType, entry;
+            getline(ss, role, ',');
+            getline(ss, username, ',');
+            getline(ss, trips, ',');
+            getline(ss, totalFare, ',');
+            getline(ss, lastRideID, ',');
+            getline(ss, byType);
+            if (trips.empty() || totalFare.empty())
+            {
+                continue;
+            }
+
+            RideStats stats;
+            stats.trips = stoi(trips);
+            stats.totalFare = stod(totalFare);
+            stats.lastRideID = lastRideID;
+            stringstream typeStream(byType);
+            while (getline(typeStream, entry, ';'))
+            {
+                size_t colon = entry.find(':');
+                if (colon != string::npos)
+                {
+                    stats.tripsByVehicleType[entry.substr(0, colon)] = stoi(entry.substr(colon + 1));
+                }
+            }
+            (role == "driver" ? driverStats : userStats)[username] = stats;
+            entries++;
+        }
+        statsFile.close();
+
+        // Drop superseded entries once they make up most of the file
+        if (entries > 2 * (userStats.size() + driverStats.size()))
+        {
+            save();
+        }
+    }
+
+    // Function to rewrite the stats file with one entry per user and driver
+    void save() const
+    {
+        ofstream statsFile(RIDE_STATS_FILE);
+        for (const auto &entry : userStats)
+        {
+            writeEntry(statsFile, "user", entry.first, entry.second);
+        }
+        for (const auto &entry : driverStats)
+        {
+            writeEntry(statsFile, "driver", entry.first, entry.second);
+        }
+        statsFile.close();
+    }
+
+    // Function to count a newly recorded ride towards its user and driver
+    void addRide(const Ride &ride)
+    {
+        countRide(ride);
 
-    double a = sin(dLat / 2) * sin(dLat / 2) +
-               cos(lat1 * M_PI / 180.0) * cos(lat2 * M_PI / 180.0) *
-               sin(dLon / 2) * sin(dLon / 2);
-    double c = 2 * atan2(sqrt(a), sqrt(1 - a));
-    return R * c; // Distance in kilometers
-}
+        ofstream statsFile(RIDE_STATS_FILE, ios::app);
+        writeEntry(statsFile, "user", ride.userID, userStats[ride.userID]);
+        writeEntry(statsFile, "driver", ride.driverID, driverStats[ride.driverID]);
+        statsFile.close();
+    }
 
+    // Function to count a ride in memory only; bulk loaders call save() once at the end
+    void countRide(const Ride &ride)
+    {
+        userStats[ride.userID].addRide(ride.rideID, ride.fare, ride.vehicleType);
+        driverStats[ride.driverID].addRide(ride.rideID, ride.fare, ride.vehicleType);
+    }
 
-// Structure to represent a ride
-struct Ride
-{
-    string rideID;
-    string userID;
-    string driverID;
-    Place pickupLocation;
-    Place dropoffLocation;
-    double fare;
-    string vehicleType; // Changed to string
+    // Getters; a username without rides gets empty statistics
+    RideStats forUser(const string &username) const
+    {
+        auto it = userStats.find(username);
+        return it == userStats.end() ? RideStats() : it->second;
+    }
 
-    Ride(string id, string user, string driver, Place pickup, Place dropoff, double fareAmount, string vType)
-        : rideID(id), userID(user), driverID(driver), pickupLocation(pickup), dropoffLocation(dropoff), fare(fareAmount), vehicleType(vType) {}
+    RideStats forDriver(const string &username) const
+    {
+        auto it = driverStats.find(username);
+        return it == driverStats.end() ? RideStats() : it->second;
+    }
 };
 
-// Parent class for Human
-class Human
+// Number of rides shown per page of ride history
+const int RIDES_PER_PAGE = 20;
+
+// Class to format a whole screen into one reusable buffer and write it to the console at once
+class ScreenBuffer
 {
-protected:
-    string name;
-    int age;
-    string phoneNumber;
+private:
+    string buffer;
 
 public:
     // Constructor
-    Human(string n, int a, string phone) : name(n), age(a), phoneNumber(phone) {}
-
-    // Getters
-    string getName() const { return name; }
-    int getAge() const { return age; }
-    string getPhoneNumber() const { return phoneNumber; }
-};
+    ScreenBuffer() { buffer.reserve(4096); }
 
-// Parent class for Vehicle
-class Vehicle
-{
-protected:
-    string vehicleNumber;
-    string type; // Changed to string
+    ScreenBuffer &operator<<(const string &text)
+    {
+        buffer += text;
+        return *this;
+    }
 
-public:
-    // Constructor
-    Vehicle(string vNum, string t) : vehicleNumber(vNum), type(t) {}
+    ScreenBuffer &operator<<(const char *text)
+    {
+        buffer += text;
+        return *this;
+    }
 
-    // Getters
-    string getVehicleNumber() const { return vehicleNumber; }
-    string getType() const { return type; }
-};
+    ScreenBuffer &operator<<(char c)
+    {
+        buffer += c;
+        return *this;
+    }
 
-// Child class for User
-class User : public Human
-{
-private:
-    string username;
-    string password;
+    ScreenBuffer &operator<<(int value)
+    {
+        buffer += to_string(value);
+        return *this;
+    }
 
-public:
-    // Constructor
-    User(string n, int a, string phone, string user, string pass)
-        : Human(n, a, phone), username(user), password(pass) {}
+    ScreenBuffer &operator<<(double value)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%g", value); // Same formatting as cout
+        buffer += text;
+        return *this;
+    }
 
-    // Getters
-    string getUsername() const { return username; }
-    string getPassword() const { return password; }
+    // Function to throw away the buffered screen without showing it
+    void discard() { buffer.clear(); }
 
-    // Function to display user information
-    void displayUserInfo() const
+    // Function to write the buffered screen to the console, keeping the buffer's capacity for reuse
+    void flush()
     {
-        cout << "----------------------------------------" << endl;
-        cout << "User  Information:" << endl;
-        cout << "Name: " << getName() << endl;
-        cout << "Age: " << getAge() << endl;
-        cout << "Phone Number: " << getPhoneNumber() << endl;
-        cout << "Username: " << getUsername() << endl;
-        cout << "----------------------------------------" << endl;
+        cout.write(buffer.data(), buffer.size());
+        cout.flush();
+        buffer.clear();
     }
+};
 
-    // Function to view previous rides
-    void viewPreviousRides() const
+// Shared output buffer for the information and history screens
+ScreenBuffer screen;
+
+// Function to read the next ride of a user or a driver from the cursor onwards (caller holds rideLogMutex).
+// Returns false once the ride log is exhausted.
+bool nextMatchingRide(const vector<RideSegment> &segments, const string &username, bool asDriver,
+                      RideCursor &cursor, vector<string> &rideDetails)
+{
+    if (!cursor.nextRide.empty())
     {
-        ifstream rideFile("rides.txt");
-        string line;
-        cout << "Previous Rides:" << endl;
+        rideDetails.swap(cursor.nextRide);
+        cursor.nextRide.clear();
+        return true;
+    }
 
-        // Check if the file is open
-        if (!rideFile.is_open())
+    for (; cursor.segment < segments.size(); cursor.segment++, cursor.reader.reset())
+    {
+        // Skip segments whose summary rules out this user or driver
+        if (!segments[cursor.segment].mayContain(username))
         {
-            cout << "No previous rides found." << endl;
-            return;
+            continue;
         }
 
-        while (getline(rideFile, line))
+        // The reader lives in the cursor, so a compacted segment is decoded once rather than per page
+        if (!cursor.reader)
+        {
+            cursor.reader = make_unique<RideSegmentReader>(segments[cursor.segment]);
+        }
+        string line;
+        while (cursor.reader->next(line))
         {
             // Split the line into components
             size_t pos = 0;
-            vector<string> rideDetails;
+            rideDetails.clear();
             while ((pos = line.find(",")) != string::npos)
             {
                 rideDetails.push_back(line.substr(0, pos));
@@ -141,32 +1673,140 @@ public:
             // Ensure we have the expected number of details
             if (rideDetails.size() != 7)
             {
-                cout << "Error reading ride details." << endl;
+                screen << "Error reading ride details.\n";
                 continue;
             }
 
-            // Extract ride details
-            string rideID = rideDetails[0];
-            string userID = rideDetails[1];
-            string driverID = rideDetails[2];
-            string pickupLocation = rideDetails[3];
-            string dropoffLocation = rideDetails[4];
-            double fare = stod(rideDetails[5]);
-            string vehicleType = rideDetails[6]; // Changed to string
-
-            // Display the ride details only if the ride is associated with the current user
-            if (userID == getUsername())
-            {
-                cout << "----------------------------------------" << endl;
-                cout << "Ride ID: " << rideID << endl;
-                cout << "Driver: " << driverID << endl; // Assuming driverID is the driver's username
-                cout << "You traveled from: " << pickupLocation << " to " << dropoffLocation << endl;
-                cout << "Total Fare: $" << fare << endl;
-                cout << "Vehicle Type: " << vehicleType << endl; // Changed to string
-                cout << "----------------------------------------" << endl;
+            // Keep the ride only if it is associated with the current user or driver
+            if ((asDriver ? rideDetails[2] : rideDetails[1]) == username)
+            {
+                return true;
             }
         }
-        rideFile.close();
+    }
+    return false;
+}
+
+// Function to buffer one page of ride history for a user or a driver, starting at the cursor.
+// Returns true if there are more rides after this page.
+bool bufferRideHistoryPage(const vector<RideSegment> &segments, const string &username, bool asDriver, RideCursor &cursor)
+{
+    ProfileScope scope(PHASE_VIEW_PREVIOUS_RIDES);
+    lock_guard<mutex> lock(rideLogMutex);
+    vector<string> rideDetails;
+
+    for (int shown = 0; shown < RIDES_PER_PAGE && nextMatchingRide(segments, username, asDriver, cursor, rideDetails); shown++)
+    {
+        // Extract ride details
+        string rideID = rideDetails[0];
+        string userID = rideDetails[1];
+        string driverID = rideDetails[2];
+        string pickupLocation = rideDetails[3];
+        string dropoffLocation = rideDetails[4];
+        double fare = stod(rideDetails[5]);
+        string vehicleType = rideDetails[6]; // Changed to string
+
+        screen << "----------------------------------------\n";
+        screen << "Ride ID: " << rideID << '\n';
+        if (asDriver)
+        {
+            screen << ":User  " << userID << '\n'; // Assuming userID is the user's username
+        }
+        else
+        {
+            screen << "Driver: " << driverID << '\n'; // Assuming driverID is the driver's username
+        }
+        screen << "You traveled from: " << pickupLocation << " to " << dropoffLocation << '\n';
+        screen << "Total Fare: $" << fare << '\n';
+        screen << "Vehicle Type: " << vehicleType << '\n'; // Changed to string
+        screen << "----------------------------------------\n";
+    }
+
+    // Read ahead so another page is only offered when it will have a ride on it
+    return nextMatchingRide(segments, username, asDriver, cursor, cursor.nextRide);
+}
+
+// Function to display ride history one page at a time
+Task<> viewRideHistory(Session &session, string username, bool asDriver)
+{
+    vector<RideSegment> segments;
+    {
+        lock_guard<mutex> lock(rideLogMutex);
+        segments = listRideSegments();
+    }
+
+    screen << "Previous Rides:\n";
+    if (segments.empty())
+    {
+        screen << "No previous rides found.\n";
+        screen.flush();
+        co_return;
+    }
+
+    RideCursor cursor;
+    while (bufferRideHistoryPage(segments, username, asDriver, cursor))
+    {
+        screen << "Press Enter to see more rides or q to go back: ";
+        screen.flush();
+        string answer = co_await session.readLine();
+        if (answer == "q" || answer == "Q")
+        {
+            co_return;
+        }
+    }
+    screen.flush();
+}
+
+// Function to display the ride statistics of a user or a driver
+void displayRideStats(const RideStats &stats, bool asDriver)
+{
+    screen << "Ride Statistics:\n";
+    screen << "Total Trips: " << stats.trips << '\n';
+    char totalFare[32];
+    snprintf(totalFare, sizeof(totalFare), "%.2f", stats.totalFare); // Large totals would otherwise print in scientific notation
+    screen << (asDriver ? "Total Earnings: $" : "Total Spent: $") << totalFare << '\n';
+    for (const auto &entry : stats.tripsByVehicleType)
+    {
+        screen << entry.first << " Trips: " << entry.second << '\n';
+    }
+    screen << "Last Ride ID: " << (stats.lastRideID.empty() ? "None" : stats.lastRideID) << '\n';
+    screen << "----------------------------------------\n";
+    screen.flush();
+}
+
+// Child class for User
+class User : public Human
+{
+private:
+    string username;
+    string password;
+
+public:
+    // Constructor
+    User(string n, int a, string phone, string user, string pass)
+        : Human(n, a, phone), username(user), password(pass) {}
+
+    // Getters
+    string getUsername() const { return username; }
+    string getPassword() const { return password; }
+
+    // Function to display user information
+    void displayUserInfo() const
+    {
+        screen << "----------------------------------------\n";
+        screen << "User  Information:\n";
+        screen << "Name: " << getName() << '\n';
+        screen << "Age: " << getAge() << '\n';
+        screen << "Phone Number: " << getPhoneNumber() << '\n';
+        screen << "Username: " << getUsername() << '\n';
+        screen << "----------------------------------------\n";
+        screen.flush();
+    }
+
+    // Function to view previous rides
+    Task<> viewPreviousRides(Session &session) const
+    {
+        co_await viewRideHistory(session, getUsername(), false);
     }
 };
 
@@ -193,71 +1833,21 @@ public:
     // Function to display driver information
     void displayDriverInfo() const
     {
-        cout << "Driver Information:" << endl;
-        cout << "Name: " << getName() << endl;
-        cout << "Age: " << getAge() << endl;
-        cout << "Phone Number: " << getPhoneNumber() << endl;
-        cout << "Username: " << getUsername() << endl;
-        cout << "Vehicle Number: " << vehicle->getVehicleNumber() << endl;
-        cout << "Vehicle Type: " << vehicle->getType() << endl; // Changed to string
-        cout << "Location: " << (location ? location->name : "Not assigned") << endl;
+        screen << "Driver Information:\n";
+        screen << "Name: " << getName() << '\n';
+        screen << "Age: " << getAge() << '\n';
+        screen << "Phone Number: " << getPhoneNumber() << '\n';
+        screen << "Username: " << getUsername() << '\n';
+        screen << "Vehicle Number: " << vehicle->getVehicleNumber() << '\n';
+        screen << "Vehicle Type: " << vehicle->getType() << '\n'; // Changed to string
+        screen << "Location: " << (location ? location->name : "Not assigned") << '\n';
+        screen.flush();
     }
 
     // Function to view previous rides
-    void viewPreviousRides() const
+    Task<> viewPreviousRides(Session &session) const
     {
-        ifstream rideFile("rides.txt");
-        string line;
-        cout << "Previous Rides:" << endl;
-
-        // Check if the file is open
-        if (!rideFile.is_open())
-        {
-            cout << "No previous rides found." << endl;
-            return;
-        }
-
-        while (getline(rideFile, line))
-        {
-            // Split the line into components
-            size_t pos = 0;
-            vector<string> rideDetails;
-            while ((pos = line.find(",")) != string::npos)
-            {
-                rideDetails.push_back(line.substr(0, pos));
-                line.erase(0, pos + 1);
-            }
-            rideDetails.push_back(line); // Add the last part
-
-            // Ensure we have the expected number of details
-            if (rideDetails.size() != 7)
-            {
-                cout << "Error reading ride details." << endl;
-                continue;
-            }
-
-            // Extract ride details
-            string rideID = rideDetails[0];
-            string userID = rideDetails[1];
-            string driverID = rideDetails[2];
-            string pickupLocation = rideDetails[3];
-            string dropoffLocation = rideDetails[4];
-            double fare = stod(rideDetails[5]);
-            string vehicleType = rideDetails[6]; // Changed to string
-
-            // Display the ride details only if the ride is associated with the current driver
-            if (driverID == getUsername())
-            {
-                cout << "----------------------------------------" << endl;
-                cout << "Ride ID: " << rideID << endl;
-                cout << ":User  " << userID << endl; // Assuming userID is the user's username
-                cout << "You traveled from: " << pickupLocation << " to " << dropoffLocation << endl;
-                cout << "Total Fare: $" << fare << endl;
-                cout << "Vehicle Type: " << vehicleType << endl; // Changed to string
-                cout << "----------------------------------------" << endl;
-            }
-        }
-        rideFile.close();
+        co_await viewRideHistory(session, getUsername(), true);
     }
 
     // Function to update driver's location
@@ -290,17 +1880,17 @@ bool usernameExists(const string &username, const string &filename)
 }
 
 // Function to register a user
-void registerUser ()
+Task<> registerUser(Session &session)
 {
     string name, username, password, phoneNumber;
     cout << "Enter your name: ";
-    getline(cin, name );
+    name = co_await session.readLine();
     cout << "Enter your age: ";
     int age;
     int count = 1;
     while (count)
     {
-        cin >> age;
+        age = co_await readNumber(session);
         if (age < 18 || age > 100)
         {
             cout << "Enter valid age :";
@@ -311,13 +1901,12 @@ void registerUser ()
             count = 0;
         }
     }
-    cin.ignore();
 
     bool Validnum = false;
     while (!Validnum)
     {
         cout << "Enter your phone number: ";
-        getline(cin, phoneNumber);
+        phoneNumber = co_await session.readLine();
 
         // Check if phone number has exactly 10 digits
         if (phoneNumber.length() == 10 &&
@@ -335,7 +1924,7 @@ void registerUser ()
     while (!validUsername)
     {
         cout << "Enter your username: ";
-        getline(cin, username);
+        username = co_await session.readLine();
 
         if (usernameExists(username, "users.txt"))
         {
@@ -347,7 +1936,7 @@ void registerUser ()
         }
     }
     cout << "Enter your password: ";
-    getline(cin, password);
+    password = co_await session.readLine();
 
     User user(name, age, phoneNumber, username, password);
 
@@ -369,18 +1958,183 @@ vector<Place> initializePlaces()
     return places;
 }
 
+// Function to look up a place by name, keeping just the name if it is not a known place
+Place lookupPlace(const string &name)
+{
+    for (const Place &place : initializePlaces())
+    {
+        if (place.name == name)
+        {
+            return place;
+        }
+    }
+    return Place(name, 0, 0, 0);
+}
+
+// Structure to represent a driver available for dispatch
+struct FleetDriver
+{
+    string username;
+    string name;
+    Place location;
+    bool onPooledRoute = false; // Driving a shared ride, so not free for other dispatches
+};
+
+// Container holding the drivers of one vehicle class
+template <typename Traits>
+struct FleetOf
+{
+    vector<FleetDriver> drivers;
+    vector<double> distances; // Scratch space for findNearestDriver, reused across bookings
+};
+
+// All drivers, kept in a separate container per vehicle class
+struct Fleet
+{
+    FleetOf<CarTraits> cars;
+    FleetOf<AutoTraits> autos;
+    FleetOf<BikeTraits> bikes;
+
+    template <typename Traits>
+    FleetOf<Traits> &of()
+    {
+        if constexpr (Traits::id == VehicleClass::Car)
+            return cars;
+        else if constexpr (Traits::id == VehicleClass::Auto)
+            return autos;
+        else
+            return bikes;
+    }
+
+    // Function to add a driver to the container of its vehicle class
+    void add(VehicleClass vehicleClass, const FleetDriver &driver)
+    {
+        switch (vehicleClass)
+        {
+        case VehicleClass::Car:
+            cars.drivers.push_back(driver);
+            break;
+        case VehicleClass::Auto:
+            autos.drivers.push_back(driver);
+            break;
+        case VehicleClass::Bike:
+            bikes.drivers.push_back(driver);
+            break;
+        case VehicleClass::Unknown:
+            break;
+        }
+    }
+
+    // Function to get a driver by vehicle class and position in its container
+    FleetDriver &driverAt(VehicleClass vehicleClass, size_t index)
+    {
+        switch (vehicleClass)
+        {
+        case VehicleClass::Car:
+            return cars.drivers[index];
+        case VehicleClass::Auto:
+            return autos.drivers[index];
+        case VehicleClass::Bike:
+            return bikes.drivers[index];
+        case VehicleClass::Unknown:
+            break;
+        }
+        throw invalid_argument("No drivers for an unknown vehicle class");
+    }
+};
+
+// Function to advance every shared ride to the given time and retire the finished ones,
+// leaving their drivers at the last stop and free for dispatch again
+void retireFinishedPooledRides(vector<PooledRide> &activeRides, Fleet &fleet, time_t now)
+{
+    for (size_t i = 0; i < activeRides.size();)
+    {
+        if (advancePooledRide(activeRides[i], now))
+        {
+            ++i;
+            continue;
+        }
+
+        FleetDriver &driver = fleet.driverAt(activeRides[i].vehicleClass, activeRides[i].driverIndex);
+        driver.onPooledRoute = false;
+        driver.location = activeRides[i].position;
+        activeRides[i] = move(activeRides.back());
+        activeRides.pop_back();
+    }
+}
+
+// Function to load every driver in drivers.txt into the fleet
+void loadFleet(Fleet &fleet)
+{
+    ifstream driverFile("drivers.txt");
+    string line;
+
+    while (getline(driverFile, line))
+    {
+        // Fields: username,password,name,age,phone,vehicleNumber,vehicleType,location
+        vector<string> fields;
+        stringstream ss(line);
+        string field;
+        while (getline(ss, field, ','))
+        {
+            fields.push_back(field);
+        }
+        if (fields.size() != 8)
+        {
+            continue;
+        }
+
+        FleetDriver driver = {fields[0], fields[2], lookupPlace(fields[7])};
+        fleet.add(parseVehicleClass(fields[6]), driver);
+    }
+    driverFile.close();
+}
+
+// Function to find the nearest driver of a vehicle class within its search radius; the driver's
+// distance from the pickup is returned through driverDistance
+template <typename Traits>
+FleetDriver *findNearestDriver(FleetOf<Traits> &fleet, const Place &pickupPlace, double &driverDistance)
+{
+    ProfileScope scope(PHASE_FIND_NEAREST_DRIVER);
+
+    // Distances to every driver in one batch, then a plain scan for the smallest
+    vector<double> &distances = fleet.distances;
+    distances.resize(fleet.drivers.size());
+    {
+        ProfileScope distanceScope(PHASE_CALCULATE_DISTANCE);
+        for (size_t i = 0; i < fleet.drivers.size(); ++i)
+        {
+            distances[i] = calculateDistance(pickupPlace.latitude, pickupPlace.longitude, fleet.drivers[i].location.latitude, fleet.drivers[i].location.longitude);
+        }
+    }
+
+    FleetDriver *nearestDriver = nullptr;
+    double minDistance = numeric_limits<double>::max();
+    for (size_t i = 0; i < distances.size(); ++i)
+    {
+        if (distances[i] < minDistance && distances[i] <= Traits::searchRadiusKm && !fleet.drivers[i].onPooledRoute)
+        {
+            minDistance = distances[i];
+            nearestDriver = &fleet.drivers[i]; // Update nearest driver
+        }
+    }
+
+    driverDistance = minDistance;
+    return nearestDriver; // Return the nearest driver
+}
+
 // Function to register a driver
-void registerDriver()
+Task<> registerDriver(Session &session, Fleet &fleet)
 {
     string name, username, password, phoneNumber, vehicleNumber, vehicleType;
     cout << "Enter your name: ";
-    getline(cin, name);
+    name = co_await session.readLine();
     cout << "Enter your age: ";
     int age;
     int count = 1;
     while (count)
     {
-        cin >> age;
+        age = co_await readNumber(session);
         if (age < 18 || age > 60)
         {
             cout << "You don't have minimum age to register as a driver";
@@ -392,12 +2146,11 @@ void registerDriver()
             count = 0;
         }
     }
-    cin.ignore();
     bool Validnum = false;
     while (!Validnum)
     {
         cout << "Enter your phone number: ";
-        getline(cin, phoneNumber);
+        phoneNumber = co_await session.readLine();
 
         if (phoneNumber.length() == 10 &&
             all_of(phoneNumber.begin(), phoneNumber.end(), ::isdigit))
@@ -414,7 +2167,7 @@ void registerDriver()
     while (!validUsername)
     {
         cout << "Enter your username: ";
-        getline(cin, username);
+        username = co_await session.readLine();
 
         if (usernameExists(username, "drivers.txt"))
         {
@@ -427,11 +2180,20 @@ void registerDriver()
     }
 
     cout << "Enter your password: ";
-    getline(cin, password);
+    password = co_await session.readLine();
     cout << "Enter your vehicle number: ";
-    getline(cin, vehicleNumber);
-    cout << "Enter your vehicle type (Car/Auto/Bike): ";
-    getline(cin, vehicleType);
+    vehicleNumber = co_await session.readLine();
+    VehicleClass vehicleClass = VehicleClass::Unknown;
+    while (vehicleClass == VehicleClass::Unknown)
+    {
+        cout << "Enter your vehicle type (Car/Auto/Bike): ";
+        vehicleType = co_await session.readLine();
+        vehicleClass = parseVehicleClass(vehicleType);
+        if (vehicleClass == VehicleClass::Unknown)
+        {
+            cout << "Invalid vehicle type. Choose Car, Auto or Bike." << endl;
+        }
+    }
 
     // Display available places for driver location
     vector<Place> places = initializePlaces();
@@ -443,13 +2205,12 @@ void registerDriver()
 
     int locationChoice;
     cout << "Select your location (1-" << places.size() << "): ";
-    cin >> locationChoice;
-    cin.ignore();
+    locationChoice = co_await readNumber(session);
 
     if (locationChoice < 1 || locationChoice > places.size())
     {
         cout << "Invalid choice. Registration failed." << endl;
-        return;
+        co_return;
     }
 
     Place *location = new Place(places[locationChoice - 1]);
@@ -460,93 +2221,280 @@ void registerDriver()
     driverFile << username << "," << password << "," << name << "," << age << "," << phoneNumber << "," << vehicleNumber << "," << vehicleType << "," << location->name << endl;
     driverFile.close();
 
+    FleetDriver fleetDriver = {username, name, *location};
+    fleet.add(vehicleClass, fleetDriver);
+
     cout << "Driver registered successfully!" << endl;
 }
 
-// Function to find the nearest driver of a specific vehicle type
-Driver *findNearestDriver(const Place &pickupPlace, const string &vehicleType)
+// Number of seconds a cached pickup ETA stays valid
+const int ETA_TTL_SECONDS = 60;
+
+// Structure to represent a memoised fare quote for a route
+struct FareQuote
 {
-    ifstream driverFile("drivers.txt");
-    string line;
-    vector<Driver *> matchingDrivers; // Vector to store matching drivers
+    double fare;
+    double routeDistance; // Distance between pickup and drop in km
+};
 
-    while (getline(driverFile, line))
+// Structure to represent a cached estimate of how long a driver takes to reach a pickup
+struct EtaEstimate
+{
+    double minutes;
+    time_t computedAt;
+};
+
+// Class to cache fare quotes per (pickup, drop, vehicle class) and short-lived pickup ETAs.
+// Entries are stored in flat arrays indexed by place position and vehicle class. Places and
+// fare rates are fixed for the life of the process, so quotes never go stale; ETAs are
+// refreshed once they are older than ETA_TTL_SECONDS.
+class QuoteCache
+{
+private:
+    static constexpr size_t CLASS_COUNT = static_cast<size_t>(VehicleClass::Unknown); // Every real vehicle class
+
+    struct QuoteEntry
+    {
+        FareQuote quote;
+        bool cached;
+    };
+
+    struct EtaEntry
     {
-        size_t pos = 0;
-        string fileUsername, filePassword, name, phoneNumber, vehicleNumber, fileVehicleType, location;
+        bool found; // Whether any driver was free to reach the pickup
+        EtaEstimate estimate;
+        bool cached;
+    };
 
-        // Extracting the fields from the line
-        fileUsername = line.substr(0, line.find(","));
-        line.erase(0, line.find(",") + 1);
+    size_t placeCount = 0;
+    vector<QuoteEntry> quotes; // Indexed by [pickup][drop][class]
+    vector<EtaEntry> etas;     // Indexed by [pickup][class]
 
-        filePassword = line.substr(0, line.find(","));
-        line.erase(0, line.find(",") + 1);
+    // Function to size the arrays for the place list, dropping everything if it changed
+    void fitPlaces(size_t count)
+    {
+        if (count != placeCount)
+        {
+            placeCount = count;
+            quotes.assign(count * count * CLASS_COUNT, QuoteEntry{});
+            etas.assign(count * CLASS_COUNT, EtaEntry{});
+        }
+    }
 
-        name = line.substr(0, line.find(","));
-        line.erase(0, line.find(",") + 1);
+public:
+    // Function to get the quote for a route, computing and caching it on first use
+    template <typename Traits>
+    FareQuote getQuote(const vector<Place> &places, size_t pickupIndex, size_t dropIndex)
+    {
+        fitPlaces(places.size());
+        QuoteEntry &entry = quotes[(pickupIndex * placeCount + dropIndex) * CLASS_COUNT + static_cast<size_t>(Traits::id)];
+        if (!entry.cached)
+        {
+            const Place &pickupPlace = places[pickupIndex];
+            const Place &dropPlace = places[dropIndex];
+            entry.quote.fare = dropPlace.distance * Traits::fareRate;
+            entry.quote.routeDistance = calculateDistance(pickupPlace.latitude, pickupPlace.longitude, dropPlace.latitude, dropPlace.longitude);
+            entry.cached = true;
+        }
+        return entry.quote;
+    }
 
-        int age = stoi(line.substr(0, line.find(",")));
-        line.erase(0, line.find(",") + 1);
+    // Function to get the pickup ETA from the nearest driver free for dispatch. The estimate is
+    // only recomputed once it is older than ETA_TTL_SECONDS, so dispatches in between do not
+    // each pay for a second fleet scan. Returns false if no driver could reach the pickup.
+    template <typename Traits>
+    bool getEta(const vector<Place> &places, size_t pickupIndex, FleetOf<Traits> &drivers, double &minutes)
+    {
+        ProfileScope scope(PHASE_GET_ETA);
+        fitPlaces(places.size());
+        EtaEntry &entry = etas[pickupIndex * CLASS_COUNT + static_cast<size_t>(Traits::id)];
+        time_t now = time(0);
+        if (!entry.cached || now - entry.estimate.computedAt > ETA_TTL_SECONDS)
+        {
+            double driverDistance;
+            entry.found = findNearestDriver(drivers, places[pickupIndex], driverDistance) != nullptr;
+            entry.estimate.minutes = entry.found ? driverDistance / Traits::speedKmph * 60.0 : 0.0;
+            entry.estimate.computedAt = now;
+            entry.cached = true;
+        }
+        minutes = entry.estimate.minutes;
+        return entry.found;
+    }
+};
 
-        phoneNumber = line.substr(0, line.find(","));
-        line.erase(0, line.find(",") + 1);
+// Function to generate a unique ride ID using current time and a random number
+string generateRideID()
+{
+    srand(time(0)); // Seed random number generator
+    stringstream rideIDStream;
+    rideIDStream << time(0)%1000 << "-" << rand(); // Combine timestamp and random number
+    return rideIDStream.str();
+}
 
-        vehicleNumber = line.substr(0, line.find(","));
-        line.erase(0, line.find(",") + 1);
+// Function to append a ride to today's segment of the ride log and update its summary and statistics
+void recordRide(const Ride &ride, RideStatsStore &stats)
+{
+    lock_guard<mutex> lock(rideLogMutex);
+    time_t now = time(0);
+    bool added;
+    RideSegment &segment = currentRideSegment(now, added);
+
+    ofstream rideFile(segment.fileName(), ios::app);
+    rideFile << ride.rideID << "," << ride.userID << "," << ride.driverID << ","
+             << ride.pickupLocation.name << "," << ride.dropoffLocation.name << ","
+             << ride.fare << "," << ride.vehicleType << endl;
+    rideFile.close();
+
+    // Only write the index when the summary used for lookups changes: a new segment or new
+    // bloom filter bits. The newer maxTime alone is kept in memory and saved with the next
+    // change or at exit.
+    size_t previousSetBits = segment.bloomSetBits;
+    segment.maxTime = now;
+    segment.addID(ride.userID);
+    segment.addID(ride.driverID);
+    rideSegmentIndexDirty = true;
+    if (added || segment.bloomSetBits != previousSetBits)
+    {
+        saveRideSegmentIndex();
+    }
 
-        // Now the next part is the vehicle type
-        fileVehicleType = line.substr(0, line.find(",")); // Get vehicle type
-        line.erase(0, line.find(",") + 1);                // Remove vehicle type from line
+    stats.addRide(ride);
+}
 
-        // The remaining part of the line is the location
-        location = line; // This should be the last part, which is the driver's location
+// Function to update a driver's location in the drivers.txt file
+void updateDriverLocation(const string &driverUsername, const string &placeName)
+{
+    ifstream driverFile("drivers.txt");
+    vector<string> drivers; // To store all drivers
+    string line;
 
-        // Check if the vehicle type matches
-        if (fileVehicleType == vehicleType)
+    // Read all drivers into memory
+    while (getline(driverFile, line))
+    {
+        if (line.substr(0, line.find(",")) == driverUsername) // The username is the first field
         {
-            // Create a temporary Driver object
-            Driver *tempDriver = new Driver(name, age, phoneNumber, fileUsername, filePassword, new Vehicle(vehicleNumber, fileVehicleType), new Place(location, 0, 0, 0)); // Assuming location is a string
-            matchingDrivers.push_back(tempDriver); // Add to matching drivers
+            // Update the line for the allocated driver
+            line = line.substr(0, line.rfind(",")) + "," + placeName; // Update location
         }
+        drivers.push_back(line); // Store the line
     }
     driverFile.close();
 
-    // Now find the nearest driver from the matching drivers
-    Driver *nearestDriver = nullptr;
-    double minDistance = numeric_limits<double>::max();
-
-   
-    for (Driver *driver : matchingDrivers)
+    // Write the updated drivers back to the file
+    ofstream outFile("drivers.txt");
+    for (const auto &driverLine : drivers)
     {
-        // Assuming driverLocation has latitude and longitude
-        double distance = calculateDistance(pickupPlace.latitude, pickupPlace.longitude, driver->getLocation()->latitude, driver->getLocation()->longitude); // Calculate the actual distance
+        outFile << driverLine << endl;
+    }
+    outFile.close();
+}
 
-        if (distance < minDistance)
-        {
-            minDistance = distance;
-            nearestDriver = driver; // Update nearest driver
-        }
-        else
+// Structure to represent the driver a ride request was matched to
+struct Dispatch
+{
+    string driverID;   // Empty if no driver was available
+    string driverName;
+    string finalStop;  // Where the driver's route now ends
+    bool pooled;       // Joined a shared ride already on the road
+};
+
+// Function to match a ride request to a driver, either by joining a shared ride already on the
+// road or by sending the nearest free driver. Only the in-memory fleet and shared rides are
+// updated; nothing is printed or written to the data files.
+template <typename Traits>
+Dispatch dispatchRide(const Place &pickupPlace, const Place &dropPlace, bool shareRide, Fleet &fleet,
+                      vector<PooledRide> &activeRides, QuoteCache &quotes)
+{
+    ProfileScope scope(PHASE_DISPATCH_RIDE);
+    FleetOf<Traits> &drivers = fleet.of<Traits>();
+    retireFinishedPooledRides(activeRides, fleet, time(0));
+
+    // Try to fit the request into a shared ride that is already on the road
+    if (shareRide)
+    {
+        size_t pickupStop = 0, dropStop = 0;
+        PooledRide *pooledRide = findPoolingMatch<Traits>(activeRides, pickupPlace, dropPlace, pickupStop, dropStop);
+        if (pooledRide)
         {
-            delete driver; // Clean up if not the nearest
+            joinPooledRide(*pooledRide, pickupPlace, dropPlace, pickupStop, dropStop);
+            // The driver now finishes at the last stop of the shared route
+            return Dispatch{pooledRide->driverID, pooledRide->driverName, pooledRide->stops.back().place.name, true};
         }
     }
 
-    // Clean up remaining drivers in the vector
-    for (Driver *driver : matchingDrivers)
+    // Find the nearest driver of the selected vehicle type
+    double driverDistance;
+    FleetDriver *nearestDriver = findNearestDriver(drivers, pickupPlace, driverDistance);
+    if (!nearestDriver)
     {
-        if (driver != nearestDriver)
-        {
-            delete driver; // Clean up if not the nearest
-        }
+        return Dispatch{"", "", "", false};
+    }
+
+    // Open the ride to other passengers going the same way
+    if (shareRide)
+    {
+        activeRides.emplace_back(nearestDriver - drivers.drivers.data(), nearestDriver->username, nearestDriver->name, Traits::id,
+                                 Traits::speedKmph, nearestDriver->location, pickupPlace, dropPlace);
+        nearestDriver->onPooledRoute = true;
     }
 
+    // Update driver's location to drop location
+    nearestDriver->location = dropPlace;
+    return Dispatch{nearestDriver->username, nearestDriver->name, dropPlace.name, false};
+}
 
-    return nearestDriver; // Return the nearest driver
+// Function to quote, match and record a ride for one vehicle class
+template <typename Traits>
+Task<> bookVehicle(Session &session, User *user, const vector<Place> &places, size_t pickupIndex, size_t dropIndex,
+                   Fleet &fleet, vector<PooledRide> &activeRides, RideStatsStore &stats, QuoteCache &quotes)
+{
+    const Place &pickupPlace = places[pickupIndex];
+    const Place &dropPlace = places[dropIndex];
+
+    // Look up the fare for this route
+    FareQuote quote = quotes.getQuote<Traits>(places, pickupIndex, dropIndex);
+    double fare = quote.fare;
+    cout << "Your ride from " << pickupPlace.name << " to " << dropPlace.name << " (" << quote.routeDistance << " km) will cost: $" << fare << endl;
+
+    double etaMinutes;
+    if (quotes.getEta<Traits>(places, pickupIndex, fleet.of<Traits>(), etaMinutes))
+    {
+        cout << "Estimated pickup time: " << static_cast<int>(ceil(etaMinutes)) << " minutes" << endl;
+    }
+
+    bool shareRide = false;
+    if constexpr (Traits::capacity > 1)
+    {
+        cout << "Would you like to share your ride with other passengers? (y/n): ";
+        string shareChoice = co_await session.readLine();
+        shareRide = (shareChoice == "y" || shareChoice == "Y");
+    }
+
+    Dispatch dispatch = dispatchRide<Traits>(pickupPlace, dropPlace, shareRide, fleet, activeRides, quotes);
+    if (dispatch.driverID.empty())
+    {
+        cout << "No available drivers of the selected type at the moment." << endl;
+        co_return;
+    }
+
+    if (dispatch.pooled)
+    {
+        cout << "You have been added to a shared ride with driver " << dispatch.driverName << "." << endl;
+    }
+    else
+    {
+        cout << "Driver " << dispatch.driverName << " has been allocated to your ride." << endl;
+    }
+
+    // Record the ride and update the driver's location in the drivers.txt file
+    ProfileScope scope(PHASE_RECORD_RIDE);
+    Ride ride(generateRideID(), user->getUsername(), dispatch.driverID, pickupPlace, dropPlace, fare, Traits::name);
+    recordRide(ride, stats);
+    updateDriverLocation(dispatch.driverID, dispatch.finalStop);
 }
 
 // Function to book a ride
-void bookRide(User *user, vector<Place> &places)
+Task<> bookRide(Session &session, User *user, vector<Place> &places, Fleet &fleet, vector<PooledRide> &activeRides, RideStatsStore &stats, QuoteCache &quotes)
 {
     cout << "Available Pickup Places:" << endl;
     for (size_t i = 0; i < places.size(); ++i)
@@ -556,20 +2504,21 @@ void bookRide(User *user, vector<Place> &places)
 
     int pickupChoice;
     cout << "Select your pickup place (1-" << places.size() << "): ";
-    cin >> pickupChoice;
-    cin.ignore();
+    pickupChoice = co_await readNumber(session);
 
     if (pickupChoice < 1 || pickupChoice > places.size())
     {
         cout << "Invalid choice. Returning to menu." << endl;
-        return;
+        co_return;
     }
 
-    Place pickupPlace = places[pickupChoice - 1];
-
     cout << "Select vehicle type (Car/Auto/Bike): ";
-    string vehicleType;
-    getline(cin, vehicleType);
+    VehicleClass vehicleClass = parseVehicleClass(co_await session.readLine());
+    if (vehicleClass == VehicleClass::Unknown)
+    {
+        cout << "Invalid vehicle type. Returning to menu." << endl;
+        co_return;
+    }
 
     cout << "Available Drop Places:" << endl;
     for (size_t i = 0; i < places.size(); ++i)
@@ -579,84 +2528,38 @@ void bookRide(User *user, vector<Place> &places)
 
     int dropChoice;
     cout << "Select your drop place (1-" << places.size() << "): ";
-    cin >> dropChoice;
-    cin.ignore();
+    dropChoice = co_await readNumber(session);
 
     if (dropChoice < 1 || dropChoice > places.size())
     {
         cout << "Invalid choice. Returning to menu." << endl;
-        return;
+        co_return;
     }
 
-    Place dropPlace = places[dropChoice - 1];
-
-    // Calculate fare based on distance (for simplicity, assume fare is $1 per km)
-    double fare = dropPlace.distance * 1.0; // $1 per km
-    cout << "Your ride from " << pickupPlace.name << " to " << dropPlace.name << " will cost: $" << fare << endl;
-
-    // Find the nearest driver of the selected vehicle type
-    Driver *nearestDriver = findNearestDriver(pickupPlace, vehicleType);
-    if (nearestDriver)
-    {
-        cout << "Driver " << nearestDriver->getName() << " has been allocated to your ride." << endl;
-
-        // Generate a unique ride ID using current time and a random number
-        srand(time(0)); // Seed random number generator
-        stringstream rideIDStream;
-        rideIDStream << time(0)%1000 << "-" << rand(); // Combine timestamp and random number
-        string rideID = rideIDStream.str();
-
-        Ride ride(rideID, user->getUsername(), nearestDriver->getUsername(), pickupPlace, dropPlace, fare, vehicleType);
-        ofstream rideFile("rides.txt", ios::app);
-        rideFile << ride.rideID << "," << ride.userID << "," << ride.driverID << ","
-                 << ride.pickupLocation.name << "," << ride.dropoffLocation.name << ","
-                 << ride.fare << "," << ride.vehicleType << endl;
-        rideFile.close();
-
-        // Update driver's location to drop location
-        nearestDriver->updateLocation(&dropPlace);
-
-        // Update the driver's location in the drivers.txt file
-        ifstream driverFile("drivers.txt");
-        vector<string> drivers; // To store all drivers
-        string line;
-
-        // Read all drivers into memory
-        while (getline(driverFile, line))
-        {
-            if (line.find(nearestDriver->getUsername()) != string::npos)
-            {
-                // Update the line for the allocated driver
-                line = line.substr(0, line.rfind(",")) + "," + dropPlace.name; // Update location
-            }
-            drivers.push_back(line); // Store the line
-        }
-        driverFile.close();
-
-        // Write the updated drivers back to the file
-        ofstream outFile("drivers.txt");
-        for (const auto &driverLine : drivers)
-        {
-            outFile << driverLine << endl;
-        }
-        outFile.close();
-
-        delete nearestDriver; // Clean up after use
-    }
-    else
+    switch (vehicleClass)
     {
-        cout << "No available drivers of the selected type at the moment." << endl;
+    case VehicleClass::Car:
+        co_await bookVehicle<CarTraits>(session, user, places, pickupChoice - 1, dropChoice - 1, fleet, activeRides, stats, quotes);
+        break;
+    case VehicleClass::Auto:
+        co_await bookVehicle<AutoTraits>(session, user, places, pickupChoice - 1, dropChoice - 1, fleet, activeRides, stats, quotes);
+        break;
+    case VehicleClass::Bike:
+        co_await bookVehicle<BikeTraits>(session, user, places, pickupChoice - 1, dropChoice - 1, fleet, activeRides, stats, quotes);
+        break;
+    case VehicleClass::Unknown:
+        break;
     }
 }
 
 // Function to login as a user
-User  *loginUser ()
+Task<User *> loginUser(Session &session)
 {
     string username, password;
     cout << "Enter your username: ";
-    getline(cin, username);
+    username = co_await session.readLine();
     cout << "Enter your password: ";
-    getline(cin, password);
+    password = co_await session.readLine();
 
     ifstream userFile("users.txt");
     string line;
@@ -684,23 +2587,23 @@ User  *loginUser ()
     if (loginSuccess)
     {
         cout << "Login successful!" << endl;
-        return loggedInUser ;
+        co_return loggedInUser ;
     }
     else
     {
         cout << "Invalid credentials. Please try again." << endl;
-        return nullptr;
+        co_return nullptr;
     }
 }
 
 // Function to login as a driver
-Driver *loginDriver()
+Task<Driver *> loginDriver(Session &session)
 {
     string username, password;
     cout << "Enter your username: ";
-    getline(cin, username);
+    username = co_await session.readLine();
     cout << "Enter your password: ";
-    getline(cin, password);
+    password = co_await session.readLine();
 
     ifstream driverFile("drivers.txt");
     string line;
@@ -730,17 +2633,17 @@ Driver *loginDriver()
     if (loginSuccess)
     {
         cout << "Login successful!" << endl;
-        return loggedInDriver;
+        co_return loggedInDriver;
     }
     else
     {
         cout << "Invalid credentials. Please try again." << endl;
-        return nullptr;
+        co_return nullptr;
     }
 }
 
 // Function to display user menu after login
-void userMenu(User *user, vector<Place> &places)
+Task<> userMenu(Session &session, User *user, vector<Place> &places, Fleet &fleet, vector<PooledRide> &activeRides, RideStatsStore &stats, QuoteCache &quotes)
 {
     int choice;
     do
@@ -751,19 +2654,19 @@ void userMenu(User *user, vector<Place> &places)
         cout << "3. View Previous Rides" << endl;
         cout << "4. Logout" << endl;
         cout << "Enter your choice: ";
-        cin >> choice;
-        cin.ignore(); // To ignore the newline character after the choice input
+        choice = co_await readNumber(session);
 
         switch (choice)
         {
         case 1:
             user->displayUserInfo();
+            displayRideStats(stats.forUser(user->getUsername()), false);
             break;
         case 2:
-            bookRide(user, places);
+            co_await bookRide(session, user, places, fleet, activeRides, stats, quotes);
             break;
         case 3:
-            user->viewPreviousRides();
+            co_await user->viewPreviousRides(session);
             break;
         case 4:
             cout << "Logging out..." << endl;
@@ -775,7 +2678,7 @@ void userMenu(User *user, vector<Place> &places)
 }
 
 // Function to display driver menu after login
-void driverMenu(Driver *driver)
+Task<> driverMenu(Session &session, Driver *driver, RideStatsStore &stats)
 {
     int choice;
     do
@@ -785,16 +2688,16 @@ void driverMenu(Driver *driver)
         cout << "2. View Previous Rides" << endl;
         cout << "3. Logout" << endl;
         cout << "Enter your choice: ";
-        cin >> choice;
-        cin.ignore(); // To ignore the newline character after the choice input
+        choice = co_await readNumber(session);
 
         switch (choice)
         {
         case 1:
             driver->displayDriverInfo();
+            displayRideStats(stats.forDriver(driver->getUsername()), true);
             break;
         case 2:
-            driver->viewPreviousRides();
+            co_await driver->viewPreviousRides(session);
             break;
         case 3:
             cout << "Logging out..." << endl;
@@ -806,9 +2709,8 @@ void driverMenu(Driver *driver)
 }
 
 // Main menu function
-void mainMenu()
+Task<> mainMenu(Session &session, vector<Place> &places, Fleet &fleet, vector<PooledRide> &activeRides, RideStatsStore &stats, QuoteCache &quotes)
 {
-    vector<Place> places = initializePlaces();
     int choice;
     do
     {
@@ -819,33 +2721,32 @@ void mainMenu()
         cout << "4. Login as Driver" << endl;
         cout << "5. Exit" << endl;
         cout << "Enter your choice: ";
-        cin >> choice;
-        cin.ignore(); // To ignore the newline character after the choice input
+        choice = co_await readNumber(session);
 
         switch (choice)
         {
         case 1:
-            registerUser ();
+            co_await registerUser(session);
             break;
         case 2:
-            registerDriver();
+            co_await registerDriver(session, fleet);
             break;
         case 3:
         {
-            User *user = loginUser ();
+            User *user = co_await loginUser(session);
             if (user)
             {
-                userMenu(user, places);
+                co_await userMenu(session, user, places, fleet, activeRides, stats, quotes);
                 delete user; // Clean up after use
             }
             break;
         }
         case 4:
         {
-            Driver *driver = loginDriver();
+            Driver *driver = co_await loginDriver(session);
             if (driver)
             {
-                driverMenu(driver);
+                co_await driverMenu(session, driver, stats);
                 delete driver; // Clean up after use
             }
             break;
@@ -859,9 +2760,411 @@ void mainMenu()
     } while (choice != 5);
 }
 
+// Function to parse a CSV file on all available cores. The file is split into chunks at line
+// boundaries, each thread splits the lines of one chunk into fields, and the rows come back
+// in file order. Returns false if the file cannot be read.
+bool parseCsvParallel(const string &fileName, vector<vector<string>> &rows)
+{
+    ifstream file(fileName, ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    string data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    file.close();
+
+    size_t threadCount = max(1u, thread::hardware_concurrency());
+    vector<size_t> bounds = {0};
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        size_t end = data.find('\n', max(bounds.back(), data.size() * i / threadCount));
+        bounds.push_back(end == string::npos ? data.size() : end + 1);
+    }
+    bounds.push_back(data.size());
+
+    vector<vector<vector<string>>> chunks(threadCount);
+    vector<thread> workers;
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        workers.emplace_back([&, i]()
+                             {
+            size_t pos = bounds[i];
+            while (pos < bounds[i + 1])
+            {
+                size_t end = min(data.find('\n', pos), bounds[i + 1]);
+                string_view line(data.data() + pos, end - pos);
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.remove_suffix(1);
+                }
+                if (!line.empty())
+                {
+                    vector<string> fields;
+                    size_t start = 0, comma;
+                    while ((comma = line.find(',', start)) != string_view::npos)
+                    {
+                        fields.emplace_back(line.substr(start, comma - start));
+                        start = comma + 1;
+                    }
+                    fields.emplace_back(line.substr(start));
+                    chunks[i].push_back(move(fields));
+                }
+                pos = end + 1;
+            } });
+    }
+    for (thread &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (vector<vector<string>> &chunk : chunks)
+    {
+        move(chunk.begin(), chunk.end(), back_inserter(rows));
+    }
+    return true;
+}
+
+// Function to collect every username already in a data file
+unordered_set<string> loadUsernames(const string &filename)
+{
+    ifstream file(filename);
+    unordered_set<string> usernames;
+    string line, username;
+
+    while (getline(file, line))
+    {
+        stringstream ss(line);
+        getline(ss, username, ','); // The username is the first field in each line
+        usernames.insert(username);
+    }
+    file.close();
+    return usernames;
+}
+
+// Function to check that a field is a whole number within a range
+bool isNumberInRange(const string &text, int low, int high)
+{
+    if (text.empty() || text.size() > 3 || !all_of(text.begin(), text.end(), ::isdigit))
+    {
+        return false;
+    }
+    int value = stoi(text);
+    return value >= low && value <= high;
+}
+
+// Function to append imported users or drivers whose username is new, applying the same
+// checks as registration. Returns the number of records written.
+size_t importAccounts(const vector<vector<string>> &rows, const string &filename, bool drivers, size_t &duplicates, size_t &invalid)
+{
+    unordered_set<string> usernames = loadUsernames(filename);
+    ofstream out(filename, ios::app);
+    size_t imported = 0;
+
+    for (const vector<string> &fields : rows)
+    {
+        bool valid = fields.size() == (drivers ? 8u : 5u) && !fields[0].empty() &&
+                     isNumberInRange(fields[3], 18, drivers ? 60 : 100) &&
+                     fields[4].length() == 10 && all_of(fields[4].begin(), fields[4].end(), ::isdigit);
+        if (valid && drivers)
+        {
+            valid = parseVehicleClass(fields[6]) != VehicleClass::Unknown &&
+                    lookupPlace(fields[7]).latitude != 0;
+        }
+        if (!valid)
+        {
+            invalid++;
+            continue;
+        }
+        if (!usernames.insert(fields[0]).second)
+        {
+            duplicates++;
+            continue;
+        }
+
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            out << (i > 0 ? "," : "") << fields[i];
+        }
+        out << "\n";
+        imported++;
+    }
+    out.close();
+    return imported;
+}
+
+// Largest number of rides an import writes to one ride log segment
+const size_t RIDE_IMPORT_SEGMENT_ROWS = 10000;
+
+// Function to append imported historical rides to the ride log, updating the segment summaries
+// and the ride statistics once for the whole batch. The rides carry no time, so they are filed
+// under today, split into new segments of at most RIDE_IMPORT_SEGMENT_ROWS rides each with a
+// bloom filter sized for the IDs in it.
+size_t importRides(const vector<vector<string>> &rows, size_t &invalid)
+{
+    // Apply the same checks a booking would: a known vehicle type, known places and a fare
+    vector<const vector<string> *> valid;
+    vector<double> fares;
+    for (const vector<string> &fields : rows)
+    {
+        char *end = nullptr;
+        double fare = fields.size() == 7 ? strtod(fields[5].c_str(), &end) : 0;
+        if (fields.size() != 7 || end == fields[5].c_str() || *end != '\0' || !isfinite(fare) || fare < 0 ||
+            parseVehicleClass(fields[6]) == VehicleClass::Unknown ||
+            lookupPlace(fields[3]).latitude == 0 || lookupPlace(fields[4]).latitude == 0)
+        {
+            invalid++;
+            continue;
+        }
+        valid.push_back(&fields);
+        fares.push_back(fare);
+    }
+
+    RideStatsStore stats;
+    stats.load();
+
+    lock_guard<mutex> lock(rideLogMutex);
+    time_t now = time(0);
+    for (size_t first = 0; first < valid.size(); first += RIDE_IMPORT_SEGMENT_ROWS)
+    {
+        size_t last = min(valid.size(), first + RIDE_IMPORT_SEGMENT_ROWS);
+        unordered_set<string> ids;
+        for (size_t i = first; i < last; ++i)
+        {
+            ids.insert((*valid[i])[1]);
+            ids.insert((*valid[i])[2]);
+        }
+
+        RideSegment &segment = addRideSegment(now, bloomBitsFor(ids.size()));
+        ofstream rideFile(segment.fileName(), ios::app);
+        for (size_t i = first; i < last; ++i)
+        {
+            const vector<string> &fields = *valid[i];
+            Ride ride(fields[0], fields[1], fields[2], lookupPlace(fields[3]), lookupPlace(fields[4]), fares[i], fields[6]);
+            rideFile << ride.rideID << "," << ride.userID << "," << ride.driverID << ","
+                     << ride.pickupLocation.name << "," << ride.dropoffLocation.name << ","
+                     << fields[5] << "," << ride.vehicleType << "\n";
+            segment.addID(ride.userID);
+            segment.addID(ride.driverID);
+            stats.countRide(ride);
+        }
+        rideFile.close();
+    }
+
+    saveRideSegmentIndex();
+    stats.save();
+    return valid.size();
+}
+
+// Function to bulk import users, drivers and rides from CSV files in the same layout as
+// users.txt, drivers.txt and rides.txt; "-" skips a file
+int importData(const string &usersFile, const string &driversFile, const string &ridesFile)
+{
+    const string files[3] = {usersFile, driversFile, ridesFile};
+    const char *labels[3] = {"users", "drivers", "rides"};
+
+    for (int i = 0; i < 3; ++i)
+    {
+        if (files[i] == "-")
+        {
+            continue;
+        }
+
+        vector<vector<string>> rows;
+        if (!parseCsvParallel(files[i], rows))
+        {
+            cout << "Could not read " << files[i] << "." << endl;
+            return 1;
+        }
+
+        size_t duplicates = 0, invalid = 0, imported;
+        if (i == 0)
+            imported = importAccounts(rows, "users.txt", false, duplicates, invalid);
+        else if (i == 1)
+            imported = importAccounts(rows, "drivers.txt", true, duplicates, invalid);
+        else
+            imported = importRides(rows, invalid);
+
+        cout << "Imported " << imported << " " << labels[i] << " (" << duplicates << " duplicate, "
+             << invalid << " invalid)." << endl;
+    }
+    return 0;
+}
+
+// Function to stream every line of a data file into an export file
+bool exportFile(const string &source, const string &destination)
+{
+    ifstream in(source, ios::binary);
+    ofstream out(destination, ios::binary);
+    if (!out.is_open())
+    {
+        return false;
+    }
+    if (in.is_open() && in.peek() != EOF)
+    {
+        out << in.rdbuf();
+    }
+    return true;
+}
+
+// Function to export users, drivers and the whole ride log (every segment, compacted or
+// not) as CSV files in the import layout; "-" skips a file
+int exportData(const string &usersFile, const string &driversFile, const string &ridesFile)
+{
+    if ((usersFile != "-" && !exportFile("users.txt", usersFile)) ||
+        (driversFile != "-" && !exportFile("drivers.txt", driversFile)))
+    {
+        cout << "Could not write the export files." << endl;
+        return 1;
+    }
+
+    if (ridesFile != "-")
+    {
+        ofstream out(ridesFile);
+        if (!out.is_open())
+        {
+            cout << "Could not write " << ridesFile << "." << endl;
+            return 1;
+        }
+
+        lock_guard<mutex> lock(rideLogMutex);
+        size_t exported = 0;
+        for (const RideSegment &segment : listRideSegments())
+        {
+            RideSegmentReader reader(segment);
+            string line;
+            while (reader.next(line))
+            {
+                out << line << "\n";
+                exported++;
+            }
+        }
+        cout << "Exported " << exported << " rides." << endl;
+    }
+    return 0;
+}
+
+// Number of drivers whose full ride history the synthetic workload reads
+const size_t PROFILE_HISTORY_SAMPLE = 20;
+
+// Function to run one synthetic booking for a vehicle class through the same quote and dispatch
+// code as bookVehicle. Nothing is written to the data files.
+template <typename Traits>
+void simulateBooking(const vector<Place> &places, size_t pickupIndex, size_t dropIndex, bool shareRide, Fleet &fleet,
+                     vector<PooledRide> &activeRides, QuoteCache &quotes)
+{
+    double etaMinutes;
+    quotes.getQuote<Traits>(places, pickupIndex, dropIndex);
+    quotes.getEta<Traits>(places, pickupIndex, fleet.of<Traits>(), etaMinutes);
+    dispatchRide<Traits>(places[pickupIndex], places[dropIndex], shareRide && Traits::capacity > 1, fleet, activeRides, quotes);
+}
+
+// Function to run a synthetic workload against the current data: a number of random bookings
+// followed by a full history read for a sample of drivers. The data files are only read.
+void runProfileWorkload(int bookings)
+{
+    vector<Place> places = initializePlaces();
+    Fleet fleet;
+    loadFleet(fleet);
+    vector<PooledRide> activeRides;
+    QuoteCache quotes;
+
+    srand(42); // Same workload on every run
+    for (int i = 0; i < bookings; ++i)
+    {
+        size_t pickupIndex = rand() % places.size();
+        size_t dropIndex = rand() % places.size();
+        bool shareRide = rand() % 2;
+        switch (rand() % 3)
+        {
+        case 0:
+            simulateBooking<CarTraits>(places, pickupIndex, dropIndex, shareRide, fleet, activeRides, quotes);
+            break;
+        case 1:
+            simulateBooking<AutoTraits>(places, pickupIndex, dropIndex, shareRide, fleet, activeRides, quotes);
+            break;
+        default:
+            simulateBooking<BikeTraits>(places, pickupIndex, dropIndex, shareRide, fleet, activeRides, quotes);
+            break;
+        }
+    }
+
+    vector<RideSegment> segments;
+    {
+        lock_guard<mutex> lock(rideLogMutex);
+        segments = listRideSegments();
+    }
+    vector<FleetDriver> allDrivers = fleet.cars.drivers;
+    allDrivers.insert(allDrivers.end(), fleet.autos.drivers.begin(), fleet.autos.drivers.end());
+    allDrivers.insert(allDrivers.end(), fleet.bikes.drivers.begin(), fleet.bikes.drivers.end());
+    for (size_t i = 0; i < allDrivers.size() && i < PROFILE_HISTORY_SAMPLE; ++i)
+    {
+        RideCursor cursor;
+        while (bufferRideHistoryPage(segments, allDrivers[i].username, true, cursor))
+        {
+            screen.discard();
+        }
+        screen.discard();
+    }
+}
+
 // Main function
-int main()
+int main(int argc, char *argv[])
 {
-    mainMenu();
+    // Bulk mode: --import or --export followed by the users, drivers and rides CSV files
+    if (argc == 5 && string(argv[1]) == "--import")
+    {
+        return importData(argv[2], argv[3], argv[4]);
+    }
+    if (argc == 5 && string(argv[1]) == "--export")
+    {
+        return exportData(argv[2], argv[3], argv[4]);
+    }
+
+    // Profiling: --profile-workload N runs N synthetic bookings and exits, while --profile
+    // measures a normal session; either way the totals are printed at exit
+    if (argc >= 2 && string(argv[1]) == "--profile-workload")
+    {
+        char *end = nullptr;
+        long bookings = (argc == 3) ? strtol(argv[2], &end, 10) : 0;
+        if (argc != 3 || end == argv[2] || *end != '\0' || bookings < 1 || bookings > numeric_limits<int>::max())
+        {
+            cout << "Usage: " << argv[0] << " --profile-workload <number of bookings>" << endl;
+            return 1;
+        }
+        profiler.enable();
+        runProfileWorkload(static_cast<int>(bookings));
+        profiler.report();
+        return 0;
+    }
+    if (argc == 2 && string(argv[1]) == "--profile")
+    {
+        profiler.enable();
+    }
+
+    vector<Place> places = initializePlaces();
+    Fleet fleet;
+    loadFleet(fleet);
+    vector<PooledRide> activeRides; // Shared rides currently on the road
+    RideStatsStore stats;
+    stats.load();
+    QuoteCache quotes; // Fare quotes and pickup ETAs for popular routes
+    RideLogCompactor compactor; // Compacts old ride log segments in the background
+    compactor.start();
+
+    // Every session runs as a coroutine on this thread; the console is the only front end
+    EventLoop loop;
+    Session &console = loop.addSession(0);
+    console.start(mainMenu(console, places, fleet, activeRides, stats, quotes));
+    loop.run();
+
+    compactor.stop();
+    {
+        lock_guard<mutex> lock(rideLogMutex);
+        if (rideSegmentIndexDirty)
+        {
+            saveRideSegmentIndex(); // Persist the latest ride times
+        }
+    }
+    profiler.report();
     return 0;
 }
\ No newline at end of file